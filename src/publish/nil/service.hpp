@@ -10,11 +10,17 @@
 #include "service/tcp/server/create.hpp" // IWYU pragma: export
 
 #include "service/pipe/create.hpp" // IWYU pragma: export
+#include "service/shm/create.hpp"  // IWYU pragma: export
+
+#include "service/uds/client/create.hpp" // IWYU pragma: export
+#include "service/uds/server/create.hpp" // IWYU pragma: export
 
 #include "service/udp/client/create.hpp" // IWYU pragma: export
 #include "service/udp/server/create.hpp" // IWYU pragma: export
+#include "service/udp/multicast/create.hpp" // IWYU pragma: export
 
 #include "service/ws/client/create.hpp" // IWYU pragma: export
+#include "service/ws/compression.hpp"   // IWYU pragma: export
 #include "service/ws/server/create.hpp" // IWYU pragma: export
 
 #include "service/http/server/create.hpp" // IWYU pragma: export
@@ -23,3 +29,6 @@
 #include "service/concat.hpp"  // IWYU pragma: export
 #include "service/consume.hpp" // IWYU pragma: export
 #include "service/map.hpp"     // IWYU pragma: export
+#include "service/payload.hpp" // IWYU pragma: export
+#include "service/piece.hpp"   // IWYU pragma: export
+#include "service/pool.hpp"    // IWYU pragma: export
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nil::service
+{
+    /**
+     * @brief limits for data waiting to be written to peers.
+     *  a limit of 0 means unlimited. defaults impose no limit.
+     */
+    struct Backpressure final
+    {
+        enum class Policy
+        {
+            /**
+             * @brief publish/send wait until the backlog is under the limits again.
+             *  calls made from the service thread never wait.
+             *  requires the service to run on a different thread than the caller.
+             */
+            block,
+            /**
+             * @brief discard the oldest queued (not yet written) messages of the connection.
+             */
+            drop_oldest,
+            /**
+             * @brief discard the message that would exceed the limits.
+             */
+            drop_newest,
+            /**
+             * @brief disconnect the peer that exceeds the limits.
+             */
+            disconnect
+        };
+
+        /**
+         * @brief per connection: maximum bytes waiting to be written
+         */
+        std::uint64_t max_bytes = 0;
+        /**
+         * @brief per connection: maximum messages waiting to be written
+         */
+        std::uint64_t max_messages = 0;
+        /**
+         * @brief per service: maximum bytes waiting to be written across all connections
+         */
+        std::uint64_t max_service_bytes = 0;
+        /**
+         * @brief per connection: backlog size that raises on_backpressure.
+         *  on_drain is raised once the backlog falls under half of this mark.
+         *  when 0, max_bytes is used.
+         */
+        std::uint64_t high_water = 0;
+        Policy policy = Policy::drop_newest;
+    };
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "codec.hpp"
+#include "payload.hpp"
 
 #include <cstdint>
 #include <iterator>
@@ -42,4 +43,19 @@ namespace nil::service
         return message;
     }
 
+    /**
+     * @brief same as `concat` but into a Payload (allocated from the pool).
+     *
+     * @tparam T
+     * @param data
+     * @return Payload
+     */
+    template <typename... T>
+    Payload concat_payload(const T&... data)
+    {
+        return Payload::create(
+            (0 + ... + codec<T>::size(data)),
+            [&](std::uint8_t* bytes) { concat_into(bytes, data...); }
+        );
+    }
 }
@@ -2,6 +2,8 @@
 
 #include "../ID.hpp"
 #include "../codec.hpp"
+#include "../payload.hpp"
+#include "lend.hpp"
 
 #include <nil/xalt/errors.hpp>
 #include <nil/xalt/fn_sign.hpp>
@@ -39,6 +41,8 @@ namespace nil::service::detail
         }
 
         operator ID() const = delete;
+        // handlers taking a Payload are detected separately (see Lend)
+        operator Payload() const = delete;
 
         const void* d;
         std::uint64_t* s;
@@ -51,8 +55,13 @@ namespace nil::service::detail
      *   -  void method(ID)
      *   -  void method(ID, const WithCodec&)
      *   -  void method(ID, const void*, std::uint64_t)
+     *   -  void method(ID, Payload)
      *   -  void method(const WithCodec&)
      *   -  void method(const void*, std::uint64_t)
+     *   -  void method(Payload)
+     *
+     *  a Payload shares the receive buffer of the service when it can (see Lend),
+     *  keeping it costs no copy. otherwise the message is copied.
      *
      * @tparam Handler
      * @param handler
@@ -83,6 +92,11 @@ namespace nil::service::detail
             return [handler = std::move(handler)] //
                 (ID, const void* data, std::uint64_t size) { handler(AutoCast{data, &size}); };
         }
+        else if constexpr (std::is_invocable_v<Handler, Payload>)
+        {
+            return [handler = std::move(handler)] //
+                (ID, const void* data, std::uint64_t size) { handler(Lend::adopt(data, size)); };
+        }
         // two args
         else if constexpr (std::is_invocable_v<Handler, const void*, std::uint64_t>)
         {
@@ -95,6 +109,12 @@ namespace nil::service::detail
                 (ID id, const void* data, std::uint64_t size)
             { handler(id, AutoCast(data, &size)); };
         }
+        else if constexpr (std::is_invocable_v<Handler, ID, Payload>)
+        {
+            return [handler = std::move(handler)] //
+                (ID id, const void* data, std::uint64_t size)
+            { handler(id, Lend::adopt(data, size)); };
+        }
         else
         {
             nil::xalt::undefined<Handler>(); // handler type is not supported
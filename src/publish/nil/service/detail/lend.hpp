@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../payload.hpp"
+
+#include <cstdint>
+
+namespace nil::service::detail
+{
+    /**
+     * @brief lends the buffer a service is delivering messages from to the
+     *  handlers taking a Payload, for the lifetime of the scope (calling thread only).
+     *  a handler keeping the payload keeps the buffer, the service then
+     *  receives into a new one instead of overwriting it.
+     */
+    class Lend final
+    {
+    public:
+        explicit Lend(Payload buffer);
+        ~Lend() noexcept;
+
+        Lend(Lend&&) noexcept = delete;
+        Lend(const Lend&) = delete;
+        Lend& operator=(Lend&&) noexcept = delete;
+        Lend& operator=(const Lend&) = delete;
+
+        /**
+         * @brief payload of a message being delivered.
+         *  shares the lent buffer if the message is within it, copies the message otherwise.
+         */
+        static Payload adopt(const void* data, std::uint64_t size);
+
+    private:
+        Payload buffer;
+        const Lend* previous;
+    };
+}
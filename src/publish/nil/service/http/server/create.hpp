@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../structs.hpp"
+#include "../../ws/compression.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -12,6 +13,31 @@ namespace nil::service::http::server
         std::string host;
         std::uint16_t port = 0;
         std::uint64_t buffer = 8192;
+        /**
+         * @brief limits for data waiting to be written to the websocket peers.
+         *  each route (`use_ws`) accounts for its own connections.
+         */
+        Backpressure backpressure = {};
+        /**
+         * @brief permessage-deflate of the websocket routes,
+         *  used with the peers that negotiate it
+         */
+        ws::Compression compression = {};
+        /**
+         * @brief websocket routes deliver the messages in pieces of at most `buffer` bytes
+         *  as they arrive, to the on_piece handlers (on_message is not called).
+         *  messages are then not bounded by `buffer`.
+         */
+        bool stream = false;
+        /**
+         * @brief time a connection waits for its next request after a response.
+         *  0 closes the connection after every response.
+         */
+        std::uint64_t keep_alive_ms = 5000;
+        /**
+         * @brief requests served by a connection before it is closed, 0 for no limit.
+         */
+        std::uint64_t max_requests = 100;
     };
 
     std::unique_ptr<IWebService> create(Options options);
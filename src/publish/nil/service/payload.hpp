@@ -0,0 +1,146 @@
+#pragma once
+
+#include "pool.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace nil::service
+{
+    /**
+     * @brief immutable, reference counted message buffer.
+     *  copies share the same bytes so a payload can be handed to
+     *  several services and connections without copying the data.
+     *  the bytes it allocates come from the buffer pool.
+     */
+    class Payload final
+    {
+    public:
+        Payload() = default;
+        ~Payload() noexcept = default;
+
+        Payload(const Payload&) = default;
+        Payload& operator=(const Payload&) = default;
+        Payload(Payload&&) noexcept = default;
+        Payload& operator=(Payload&&) noexcept = default;
+
+        /**
+         * @brief adopts the vector. the bytes are not copied.
+         */
+        Payload(std::vector<std::uint8_t> data) // NOLINT(hicpp-explicit-conversions)
+        {
+            if (!data.empty())
+            {
+                auto holder = std::allocate_shared<std::vector<std::uint8_t>>(
+                    pool::Allocator<std::vector<std::uint8_t>>(),
+                    std::move(data)
+                );
+                ptr = holder->data();
+                count = holder->size();
+                owner = std::move(holder);
+            }
+        }
+
+        /**
+         * @brief copies the bytes into a new payload.
+         */
+        Payload(const void* data, std::uint64_t size)
+        {
+            if (data != nullptr && size > 0)
+            {
+                auto [holder, bytes] = allocate(size);
+                std::memcpy(bytes, data, size);
+                ptr = bytes;
+                count = size;
+                owner = std::move(holder);
+            }
+        }
+
+        /**
+         * @brief creates a payload of `size` bytes and lets `fill` write them.
+         *  `fill` is called with a `std::uint8_t*` to the writable bytes.
+         */
+        template <typename Fill>
+        static Payload create(std::uint64_t size, Fill fill)
+        {
+            Payload payload;
+            if (size > 0)
+            {
+                auto [holder, bytes] = allocate(size);
+                fill(bytes);
+                payload.ptr = bytes;
+                payload.count = size;
+                payload.owner = std::move(holder);
+            }
+            return payload;
+        }
+
+        /**
+         * @brief payload of bytes kept alive by `owner`. the bytes are not copied.
+         */
+        static Payload share(
+            std::shared_ptr<const void> owner,
+            const void* data,
+            std::uint64_t size
+        )
+        {
+            Payload payload;
+            if (data != nullptr && size > 0)
+            {
+                payload.ptr = static_cast<const std::uint8_t*>(data);
+                payload.count = size;
+                payload.owner = std::move(owner);
+            }
+            return payload;
+        }
+
+        /**
+         * @brief part of the payload sharing its bytes.
+         *  `offset + size` has to be within the payload.
+         */
+        [[nodiscard]] Payload slice(std::uint64_t offset, std::uint64_t size) const
+        {
+            return share(owner, ptr + offset, size);
+        }
+
+        [[nodiscard]] const std::uint8_t* data() const
+        {
+            return ptr;
+        }
+
+        [[nodiscard]] std::uint64_t size() const
+        {
+            return count;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return count == 0;
+        }
+
+        [[nodiscard]] const std::uint8_t* begin() const
+        {
+            return ptr;
+        }
+
+        [[nodiscard]] const std::uint8_t* end() const
+        {
+            return ptr + count;
+        }
+
+    private:
+        std::shared_ptr<const void> owner;
+        const std::uint8_t* ptr = nullptr;
+        std::uint64_t count = 0;
+
+        static std::pair<std::shared_ptr<const void>, std::uint8_t*> allocate(std::uint64_t size)
+        {
+            auto holder = pool::allocate(size);
+            auto* bytes = holder.get();
+            return {std::move(holder), bytes};
+        }
+    };
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace nil::service
+{
+    /**
+     * @brief position of the bytes given to an on_piece handler within their message.
+     *  a whole message is both the first and the last piece.
+     */
+    struct Piece final
+    {
+        bool first = true;
+        bool last = true;
+    };
+}
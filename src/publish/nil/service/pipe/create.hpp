@@ -24,6 +24,13 @@ namespace nil::service::pipe
          *  - larger payloads disconnect the current endpoints before reconnect
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief receive buffer allocated up front:
+         *  - grows on demand up to `buffer` for larger payloads
+         *  - the grown part is released after `buffer_idle_ms` without use
+         */
+        std::uint64_t buffer_initial = 4096;
+        std::uint32_t buffer_idle_ms = 1000;
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace nil::service::pool
+{
+    /**
+     * @brief counters of the buffer pool, summed over all threads.
+     */
+    struct Stats final
+    {
+        // allocations served by a cached buffer
+        std::uint64_t hits = 0;
+        // allocations that needed a new buffer
+        std::uint64_t misses = 0;
+        // buffers cached for reuse
+        std::uint64_t cached = 0;
+        std::uint64_t cached_bytes = 0;
+    };
+
+    /**
+     * @brief memory of at least `size` bytes.
+     *  sizes are rounded up to a power of 2 (at least 64 bytes).
+     *  up to 1MiB, the memory comes from a cache of the calling thread which is refilled
+     *  from / spilled to a cache shared by all threads. larger sizes are not pooled.
+     */
+    void* acquire(std::uint64_t size);
+
+    /**
+     * @brief gives the memory back to the pool. `size` is the one given to `acquire`.
+     *  can be called from any thread.
+     */
+    void release(void* memory, std::uint64_t size) noexcept;
+
+    Stats stats();
+
+    /**
+     * @brief frees the buffers cached by the calling thread and by the shared cache.
+     */
+    void trim();
+
+    /**
+     * @brief standard allocator using the pool (e.g. for the control blocks of shared_ptr).
+     */
+    template <typename T>
+    struct Allocator final
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        using value_type = T;
+
+        Allocator() = default;
+
+        template <typename U>
+        Allocator(const Allocator<U>& /* other */) noexcept // NOLINT(hicpp-explicit-conversions)
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(acquire(n * sizeof(T)));
+        }
+
+        void deallocate(T* memory, std::size_t n) noexcept
+        {
+            release(memory, n * sizeof(T));
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& /* other */) const noexcept
+        {
+            return true;
+        }
+    };
+
+    /**
+     * @brief reference counted bytes, the bytes and the reference count come from the pool.
+     */
+    inline std::shared_ptr<std::uint8_t[]> allocate(std::uint64_t size)
+    {
+        return {
+            static_cast<std::uint8_t*>(acquire(size)),
+            [size](std::uint8_t* bytes) { release(bytes, size); },
+            Allocator<std::uint8_t>()
+        };
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "../structs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nil::service::shm
+{
+    struct Options final
+    {
+        /**
+         * @brief name of the shared memory object (e.g. "/my-channel").
+         *  the two services using the same name are connected to each other.
+         *  the object is created by the first one and removed by the last one.
+         */
+        std::string name;
+        /**
+         * @brief bytes of the ring of each direction, rounded up to a power of 2.
+         *  the service that creates the object decides.
+         *  payloads larger than half of it are dropped, so are the messages
+         *  published from the service thread while the ring is full.
+         */
+        std::uint64_t capacity = 1024 * 1024;
+        /**
+         * @brief time spent polling the ring before going to sleep when idle.
+         *  polling keeps the latency low at the cost of cpu time.
+         */
+        std::uint32_t spin_us = 50;
+    };
+
+    /**
+     * @brief point to point channel between two services on the same host,
+     *  through a pair of rings in shared memory.
+     *
+     *  - messages are written directly into the ring by the publishing thread
+     *    and read in place by the receiving side (no system call, no extra copy)
+     *  - a sleeping receiver is woken up through a futex
+     *  - when the ring is full, publishing blocks until there is room,
+     *    except from the service thread where the message is dropped
+     *    (as it is when another thread is writing or waiting for room)
+     *  - `stop()` releases the publishers waiting for room, their message is dropped
+     *  - messages published while the peer is not attached are dropped
+     *  - on_connect / on_disconnect are called when the peer attaches / detaches
+     *    (or its process is gone), with the same ID as on_ready
+     */
+    std::unique_ptr<IStandaloneService> create(Options options);
+}
+
+#define NIL_SERVICE_SHM_SUPPORTED 1
+#else
+#define NIL_SERVICE_SHM_SUPPORTED 0
+#endif
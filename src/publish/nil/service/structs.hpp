@@ -1,6 +1,9 @@
 #pragma once
 
+#include "backpressure.hpp"
 #include "concat.hpp"
+#include "payload.hpp"
+#include "piece.hpp"
 #include "detail/create_handler.hpp"
 #include "detail/create_message_handler.hpp"
 
@@ -61,50 +64,84 @@ namespace nil::service
         IMessageService& operator=(const IMessageService&) = delete;
         IMessageService& operator=(IMessageService&&) = delete;
 
-        virtual void publish(std::vector<std::uint8_t> payload) = 0;
-        virtual void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> payload) = 0;
-        virtual void send(std::vector<ID> ids, std::vector<std::uint8_t> payload) = 0;
+        virtual void publish(Payload payload) = 0;
+        virtual void publish_ex(std::vector<ID> ids, Payload payload) = 0;
+        virtual void send(std::vector<ID> ids, Payload payload) = 0;
+
+        /**
+         * @brief writes `piece` as a part of a message, `last` completes the message.
+         *  one message at a time, its pieces from the same thread.
+         *  websocket services write the pieces as continuation frames so a large message
+         *  is sent without building it whole. their other messages wait for `last`.
+         *  other services join the pieces and publish the message once `last` is given.
+         */
+        virtual void publish_some(Payload piece, bool last) = 0;
+
+        /**
+         * @brief `send` counterpart of `publish_some`.
+         *  websocket services have one open message for both, it must not be interleaved
+         *  with publish_some or with send_some to other ids.
+         *  other services join the pieces per set of `ids`, apart from publish_some.
+         */
+        virtual void send_some(std::vector<ID> ids, Payload piece, bool last) = 0;
+
+        void publish(std::vector<std::uint8_t> payload)
+        {
+            publish(Payload(std::move(payload)));
+        }
+
+        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> payload)
+        {
+            publish_ex(std::move(ids), Payload(std::move(payload)));
+        }
+
+        void send(std::vector<ID> ids, std::vector<std::uint8_t> payload)
+        {
+            send(std::move(ids), Payload(std::move(payload)));
+        }
 
         void publish(const void* data, std::uint64_t size)
         {
-            const auto* ptr = static_cast<const std::uint8_t*>(data);
-            publish(std::vector<std::uint8_t>(ptr, ptr + size));
+            publish(Payload(data, size));
         }
 
         void publish_ex(ID id, const void* data, std::uint64_t size)
         {
-            const auto* ptr = static_cast<const std::uint8_t*>(data);
-            publish_ex(std::vector<ID>{id}, std::vector<std::uint8_t>(ptr, ptr + size));
+            publish_ex(std::vector<ID>{id}, Payload(data, size));
         }
 
         void send(ID id, const void* data, std::uint64_t size)
         {
-            const auto* ptr = static_cast<const std::uint8_t*>(data);
-            send(std::vector<ID>{id}, std::vector<std::uint8_t>(ptr, ptr + size));
+            send(std::vector<ID>{id}, Payload(data, size));
         }
 
         template <typename T>
-            requires(!std::is_same_v<std::vector<std::uint8_t>, T>)
+            requires(!std::is_same_v<std::vector<std::uint8_t>, T> && !std::is_same_v<Payload, T>)
         void publish(const T& data)
         {
-            publish(concat(data));
+            publish(concat_payload(data));
         }
 
         template <typename T>
-            requires(!std::is_same_v<std::vector<std::uint8_t>, T>)
+            requires(!std::is_same_v<std::vector<std::uint8_t>, T> && !std::is_same_v<Payload, T>)
         void send(ID id, const T& data)
         {
-            send(std::vector<ID>{id}, concat(data));
+            send(std::vector<ID>{id}, concat_payload(data));
         }
 
         template <typename T>
-            requires(!std::is_same_v<std::vector<std::uint8_t>, T>)
+            requires(!std::is_same_v<std::vector<std::uint8_t>, T> && !std::is_same_v<Payload, T>)
         void send(std::vector<ID> ids, const T& data)
         {
-            send(std::move(ids), concat(data));
+            send(std::move(ids), concat_payload(data));
         }
 
         void send(ID id, std::vector<std::uint8_t> payload)
+        {
+            send(std::vector<ID>{id}, Payload(std::move(payload)));
+        }
+
+        void send(ID id, Payload payload)
         {
             send(std::vector<ID>{id}, std::move(payload));
         }
@@ -173,12 +210,76 @@ namespace nil::service
             impl_on_message(detail::create_message_handler(std::move(handler)));
         }
 
+        /**
+         * @brief Add a handler of message pieces, told where the piece is in its message.
+         *  Websocket services with the `stream` option call it for each piece of a message
+         *  (their on_message handlers are not called), other services once per message
+         *  with a whole piece.
+         *  Not threadsafe in case the service is already running.
+         *
+         * @param handler
+         */
+        void on_piece(std::function<void(ID, const void*, std::uint64_t, Piece)> handler)
+        {
+            impl_on_piece(std::move(handler));
+        }
+
+        /**
+         * @brief Add a handler called when the data waiting to be written to a peer
+         *  crosses the high-water mark (see Backpressure).
+         *  Not threadsafe in case the service is already running.
+         *  Services without outbound queues never call it.
+         *
+         * @param handler
+         */
+        template <typename T>
+            requires(!std::is_same_v<void, decltype(detail::create_handler(std::declval<T>()))>)
+        void on_backpressure(T handler)
+        {
+            impl_on_backpressure(detail::create_handler(std::move(handler)));
+        }
+
+        /**
+         * @brief Add a handler called when the data waiting to be written to a peer
+         *  drains back after on_backpressure.
+         *  Not threadsafe in case the service is already running.
+         *  Services without outbound queues never call it.
+         *
+         * @param handler
+         */
+        template <typename T>
+            requires(!std::is_same_v<void, decltype(detail::create_handler(std::declval<T>()))>)
+        void on_drain(T handler)
+        {
+            impl_on_drain(detail::create_handler(std::move(handler)));
+        }
+
     private:
         virtual void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler)
             = 0;
         virtual void impl_on_ready(std::function<void(ID)> handler) = 0;
         virtual void impl_on_connect(std::function<void(ID)> handler) = 0;
         virtual void impl_on_disconnect(std::function<void(ID)> handler) = 0;
+
+        virtual void impl_on_piece(
+            std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+        )
+        {
+            impl_on_message(
+                [handler = std::move(handler)](ID id, const void* data, std::uint64_t size)
+                { handler(std::move(id), data, size, Piece{}); }
+            );
+        }
+
+        virtual void impl_on_backpressure(std::function<void(ID)> handler)
+        {
+            (void)handler;
+        }
+
+        virtual void impl_on_drain(std::function<void(ID)> handler)
+        {
+            (void)handler;
+        }
     };
 
     struct IEventService
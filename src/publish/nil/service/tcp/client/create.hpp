@@ -17,6 +17,17 @@ namespace nil::service::tcp::client
          *  - maximum payload size accepted while receiving
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief receive buffer allocated up front per connection:
+         *  - grows on demand up to `buffer` for larger payloads
+         *  - the grown part is released after `buffer_idle_ms` without use
+         */
+        std::uint64_t buffer_initial = 4096;
+        std::uint32_t buffer_idle_ms = 1000;
+        /**
+         * @brief limits for data waiting to be written to the peers
+         */
+        Backpressure backpressure = {};
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
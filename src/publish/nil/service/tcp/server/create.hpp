@@ -17,6 +17,33 @@ namespace nil::service::tcp::server
          *  - maximum payload size accepted while receiving per connection
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief receive buffer allocated up front per connection:
+         *  - grows on demand up to `buffer` for larger payloads
+         *  - the grown part is released after `buffer_idle_ms` without use
+         */
+        std::uint64_t buffer_initial = 4096;
+        std::uint32_t buffer_idle_ms = 1000;
+        /**
+         * @brief limits for data waiting to be written to the peers
+         */
+        Backpressure backpressure = {};
+        /**
+         * @brief number of threads (each with its own io_context) serving the connections:
+         *  - accepted connections are distributed round-robin across the threads,
+         *    or by the kernel with `reuse_port`
+         *  - `run()` spawns the additional threads and blocks until all of them are done
+         *  - with more than 1 thread, callbacks are called concurrently from those threads
+         *  - `dispatch` runs the task on the first thread only: it is serialized with the
+         *    callbacks of that thread's connections, not with those of the other threads
+         */
+        std::uint32_t threads = 1;
+        /**
+         * @brief with more than 1 thread, each thread binds its own listener to host:port
+         *  using SO_REUSEPORT and the kernel balances the accepts between them.
+         *  ignored where SO_REUSEPORT is not available.
+         */
+        bool reuse_port = false;
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../../structs.hpp"
+#include "../fragmentation.hpp"
+#include "../reliability.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -10,6 +12,10 @@ namespace nil::service::udp::client
 {
     struct Options final
     {
+        /**
+         * @brief address or hostname of the server.
+         *  hostnames are resolved asynchronously, again on each reconnection.
+         */
         std::string host;
         std::uint16_t port = 0;
         /**
@@ -17,6 +23,36 @@ namespace nil::service::udp::client
          *  - one for receiving
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief interval of the probes sent to the server
+         */
+        std::uint32_t probe_interval_ms = 25;
+        /**
+         * @brief the server is considered disconnected when it has not answered for this long
+         */
+        std::uint32_t timeout_ms = 50;
+        /**
+         * @brief connects the socket to the server:
+         *  - the kernel skips the route lookup per datagram
+         *  - datagrams from other sources are filtered out by the kernel
+         */
+        bool connect = false;
+        /**
+         * @brief generic segmentation / receive offload (UDP_SEGMENT / UDP_GRO, linux):
+         *  - the fragments of a message are sent in one system call
+         *  - datagrams coalesced by the kernel are received in one system call
+         *  - only effective with `fragmentation`. falls back where not supported.
+         *  - reserves 64KiB for receiving
+         */
+        bool offload = false;
+        /**
+         * @brief splitting of payloads larger than the MTU (disabled by default)
+         */
+        Fragmentation fragmentation = {};
+        /**
+         * @brief reliable, ordered delivery of the messages (disabled by default)
+         */
+        Reliability reliability = {};
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
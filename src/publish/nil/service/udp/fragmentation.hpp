@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nil::service::udp
+{
+    /**
+     * @brief splitting of large payloads into datagrams that fit the path MTU,
+     *  avoiding IP fragmentation (where losing one fragment loses the datagram).
+     *  fragments are always reassembled when received, regardless of `mtu`.
+     *  a payload needs at most 65535 fragments and 4 GiB: publish/send throw
+     *  std::length_error for larger ones.
+     */
+    struct Fragmentation final
+    {
+        /**
+         * @brief largest datagram to send (udp payload, headers included):
+         *  - payloads that do not fit are sent as fragments of this size
+         *  - 0 disables fragmentation (default)
+         *  - 1472 fits an ethernet MTU of 1500 bytes over IPv4
+         *  - the peer's `buffer` must be at least this large
+         */
+        std::uint64_t mtu = 0;
+        /**
+         * @brief an incomplete message is dropped when not completed within this period
+         */
+        std::uint32_t timeout_ms = 1000;
+        /**
+         * @brief memory cap of the messages being reassembled (per socket),
+         *  bookkeeping of the fragments included.
+         *  fragments of a message that would exceed it drop the message.
+         */
+        std::uint64_t max_bytes = 16u * 1024u * 1024u;
+        /**
+         * @brief messages of a peer being reassembled at the same time.
+         *  fragments of further messages are dropped until one completes or expires.
+         */
+        std::uint32_t max_pending = 64;
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "../../structs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nil::service::udp::multicast
+{
+    struct Options final
+    {
+        /**
+         * @brief multicast group to join and publish to (e.g. 239.255.0.1)
+         */
+        std::string group;
+        std::uint16_t port = 0;
+        /**
+         * @brief address of the local interface to join / publish on.
+         *  empty lets the system pick the interface (IPv4) / uses the default scope (IPv6).
+         */
+        std::string interface_address;
+        /**
+         * @brief hops a published datagram can take. 1 keeps it on the local network.
+         */
+        std::uint8_t ttl = 1;
+        /**
+         * @brief delivers the published datagrams to the members on the same host
+         *  (the service never receives its own).
+         */
+        bool loopback = true;
+        /**
+         * @brief buffer size to use:
+         *  - one for receiving the published datagrams
+         *  - one for receiving the replies
+         */
+        std::uint64_t buffer = 1024;
+        /**
+         * @brief a member is forgotten (on_disconnect) when it has not published
+         *  or replied for this long.
+         */
+        std::uint32_t member_timeout_ms = 30000;
+    };
+
+    /**
+     * @brief member of a multicast group. `publish` sends one datagram that reaches
+     *  every member, `on_message` reports the datagrams published by the others.
+     *
+     *  - on_ready is called once the group is joined (id: the member, unique per service)
+     *  - on_connect is called once the group is joined (id: the group)
+     *  - a message's id is the member that published it. `send` to that id replies
+     *    to the member directly, `send` to the group id publishes.
+     *  - on_disconnect is called for a member after `member_timeout_ms` without its datagrams.
+     *    a later datagram of the member gets a new id.
+     *  - creation (and restart) throws if the group can not be joined
+     */
+    std::unique_ptr<IStandaloneService> create(Options options);
+}
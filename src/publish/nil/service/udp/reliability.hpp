@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+namespace nil::service::udp
+{
+    /**
+     * @brief reliable, ordered delivery of the messages sent to a peer.
+     *  each peer is an independent stream: a loss only holds back the messages
+     *  of that peer. reliable messages are always accepted when received,
+     *  regardless of `enabled`.
+     */
+    struct Reliability final
+    {
+        /**
+         * @brief sends the messages reliably (disabled by default)
+         */
+        bool enabled = false;
+        /**
+         * @brief datagrams in flight (not yet acknowledged) per peer.
+         *  the rest is queued until acknowledgements free the window.
+         *  the receiving side buffers up to this many datagrams out of order.
+         */
+        std::uint32_t window = 256;
+        /**
+         * @brief bounds of the retransmission timeout, which follows the measured round trip
+         */
+        std::uint32_t min_rto_ms = 20;
+        std::uint32_t max_rto_ms = 1000;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../../structs.hpp"
+#include "../fragmentation.hpp"
+#include "../reliability.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -18,6 +20,45 @@ namespace nil::service::udp::server
          *  - one for receiving per connection
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief number of threads (each with its own io_context and socket):
+         *  - each thread binds its own socket to host:port using SO_REUSEPORT
+         *  - the kernel balances the datagrams per peer address across the sockets
+         *  - with more than 1 thread, callbacks are called concurrently from those threads
+         *  - `dispatch` runs the task on the first thread only: it is serialized with the
+         *    callbacks of that thread's socket, not with those of the other threads
+         *  - ignored (1 thread) where SO_REUSEPORT is not available
+         */
+        std::uint32_t threads = 1;
+        /**
+         * @brief maximum datagrams per system call (recvmmsg / sendmmsg):
+         *  - each wakeup drains up to `batch` queued datagrams
+         *  - publish sends to up to `batch` peers at once
+         *  - 1 disables batching. only available on linux.
+         *  - reserves `batch * buffer` bytes per thread for receiving
+         */
+        std::uint32_t batch = 1;
+        /**
+         * @brief a peer is disconnected when it has not probed for this long.
+         *  should be a few times the `probe_interval_ms` of the clients.
+         */
+        std::uint32_t timeout_ms = 50;
+        /**
+         * @brief generic segmentation / receive offload (UDP_SEGMENT / UDP_GRO, linux):
+         *  - the fragments of a message are sent to each peer in one system call
+         *  - datagrams coalesced by the kernel are received in one system call
+         *  - only effective with `fragmentation`. falls back where not supported.
+         *  - reserves 64KiB per `batch` for receiving
+         */
+        bool offload = false;
+        /**
+         * @brief splitting of payloads larger than the MTU (disabled by default)
+         */
+        Fragmentation fragmentation = {};
+        /**
+         * @brief reliable, ordered delivery of the messages (disabled by default)
+         */
+        Reliability reliability = {};
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
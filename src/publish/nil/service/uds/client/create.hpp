@@ -0,0 +1,46 @@
+#pragma once
+
+#if defined(__unix__) || defined(__unix) || defined(unix) || defined(__APPLE__)
+
+#include "../../structs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nil::service::uds::client
+{
+    struct Options final
+    {
+        /**
+         * @brief filesystem path of the server socket
+         */
+        std::string path;
+        /**
+         * @brief socket type to use, has to match the server's:
+         *  - false: stream socket, messages use the length-prefixed framing of tcp
+         *  - true:  seqpacket socket, one record per message and no framing
+         */
+        bool seqpacket = false;
+        /**
+         * @brief buffer size to use:
+         *  - maximum payload size accepted while receiving
+         */
+        std::uint64_t buffer = 1024;
+        /**
+         * @brief receive buffer allocated up front (stream only):
+         *  - grows on demand up to `buffer` for larger payloads
+         *  - the grown part is released after `buffer_idle_ms` without use
+         */
+        std::uint64_t buffer_initial = 4096;
+        std::uint32_t buffer_idle_ms = 1000;
+        /**
+         * @brief limits for data waiting to be written to the peers
+         */
+        Backpressure backpressure = {};
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#if defined(__unix__) || defined(__unix) || defined(unix) || defined(__APPLE__)
+
+#include "../../structs.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace nil::service::uds::server
+{
+    struct Options final
+    {
+        /**
+         * @brief filesystem path of the socket, removed with the service.
+         *  a socket left behind by a server that is gone is replaced,
+         *  any other file at the path fails the creation.
+         */
+        std::string path;
+        /**
+         * @brief socket type to use:
+         *  - false: stream socket, messages use the length-prefixed framing of tcp
+         *  - true:  seqpacket socket, one record per message and no framing
+         *           (not available on every platform, e.g. macOS)
+         *  both sides have to use the same type.
+         */
+        bool seqpacket = false;
+        /**
+         * @brief buffer size to use:
+         *  - maximum payload size accepted while receiving per connection
+         */
+        std::uint64_t buffer = 1024;
+        /**
+         * @brief receive buffer allocated up front per connection (stream only):
+         *  - grows on demand up to `buffer` for larger payloads
+         *  - the grown part is released after `buffer_idle_ms` without use
+         */
+        std::uint64_t buffer_initial = 4096;
+        std::uint32_t buffer_idle_ms = 1000;
+        /**
+         * @brief limits for data waiting to be written to the peers
+         */
+        Backpressure backpressure = {};
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options);
+}
+
+#endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../structs.hpp"
+#include "../compression.hpp"
 
 #include <cstdint>
 #include <memory>
@@ -18,6 +19,20 @@ namespace nil::service::ws::client
          *  - one for receiving
          */
         std::uint64_t buffer = 1024;
+        /**
+         * @brief limits for data waiting to be written to the server
+         */
+        Backpressure backpressure = {};
+        /**
+         * @brief permessage-deflate, used if the server accepts it
+         */
+        Compression compression = {};
+        /**
+         * @brief deliver the messages in pieces of at most `buffer` bytes as they arrive
+         *  to the on_piece handlers (on_message is not called).
+         *  messages are then not bounded by `buffer`.
+         */
+        bool stream = false;
     };
 
     std::unique_ptr<IStandaloneService> create(Options options);
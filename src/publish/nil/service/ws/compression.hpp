@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../ID.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace nil::service::ws
+{
+    /**
+     * @brief permessage-deflate settings of the websocket services.
+     *  a connection compresses only when the peer negotiates the extension.
+     */
+    struct Compression final
+    {
+        bool enabled = false;
+        /**
+         * @brief LZ77 window of both directions (9 to 15)
+         */
+        int window_bits = 15;
+        /**
+         * @brief zlib memory level (1 to 9), memory per connection against speed
+         */
+        int mem_level = 4;
+        /**
+         * @brief zlib compression level (0 to 9)
+         */
+        int level = 8;
+        /**
+         * @brief messages smaller than this are sent uncompressed.
+         *  only for server connections, the ws client compresses every message.
+         */
+        std::uint64_t threshold = 0;
+        /**
+         * @brief keep the window between messages: better ratio
+         *  but the window stays allocated for every connection.
+         */
+        bool context_takeover = true;
+    };
+
+    /**
+     * @brief counters of a websocket connection.
+     *  message bytes are the payloads, wire bytes are written to / read from the socket
+     *  (frame headers, control frames and the http upgrade included).
+     */
+    struct Stats final
+    {
+        // permessage-deflate was negotiated
+        bool compressed = false;
+        std::uint64_t sent_bytes = 0;
+        std::uint64_t sent_wire_bytes = 0;
+        std::uint64_t received_bytes = 0;
+        std::uint64_t received_wire_bytes = 0;
+
+        /**
+         * @return wire bytes per message byte sent (< 1 when compression helps)
+         */
+        [[nodiscard]] double sent_ratio() const
+        {
+            return sent_bytes == 0 ? 1.0 : double(sent_wire_bytes) / double(sent_bytes);
+        }
+
+        /**
+         * @return wire bytes per message byte received
+         */
+        [[nodiscard]] double received_ratio() const
+        {
+            return received_bytes == 0 ? 1.0 : double(received_wire_bytes) / double(received_bytes);
+        }
+    };
+
+    /**
+     * @brief counters of the websocket connection identified by `id`
+     *  (IDs given to the handlers of ws::server, ws::client and http::server routes).
+     *  can be called from any thread. nullopt once the connection is closed.
+     */
+    std::optional<Stats> stats(const ID& id);
+}
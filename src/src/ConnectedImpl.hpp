@@ -1,11 +1,13 @@
 #pragma once
 
+#include <nil/service/ID.hpp>
+#include <nil/service/piece.hpp>
+
 #include <cstdint>
+#include <utility>
 
 namespace nil::service
 {
-    struct ID;
-
     template <typename Connection>
     struct ConnectedImpl
     {
@@ -18,7 +20,27 @@ namespace nil::service
         ConnectedImpl& operator=(const ConnectedImpl&) = delete;
 
         virtual void message(ID id, const void* data, std::uint64_t size) = 0;
+
+        // part of a message read in pieces
+        virtual void piece(ID id, const void* data, std::uint64_t size, Piece position)
+        {
+            (void)position;
+            message(std::move(id), data, size);
+        }
+
         virtual void connect(Connection* connection) = 0;
         virtual void disconnect(Connection* connection) = 0;
+
+        // outbound backlog of the connection crossed the high-water mark
+        virtual void backpressure(Connection* connection)
+        {
+            (void)connection;
+        }
+
+        // outbound backlog of the connection drained after backpressure
+        virtual void drain(Connection* connection)
+        {
+            (void)connection;
+        }
     };
 }
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "ReceiveBuffer.hpp"
+#include "utils.hpp"
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+namespace nil::service
+{
+    /**
+     * @brief receive buffer for the length-prefixed framing (header + payload).
+     *  each read takes as much as the buffer can hold and every complete frame
+     *  in it is parsed in one go. the incomplete tail is moved to the front
+     *  before the next read so that a frame is always contiguous.
+     *
+     *  reads go to a small storage. frames that do not fit are moved to a grown
+     *  storage (up to the maximum payload size) which is released once it was
+     *  not used for the idle period. since reads return to the small storage
+     *  whenever the buffer is drained, the grown storage can be released while
+     *  a read is pending.
+     *
+     *  the storage is lent to the handlers while frames are consumed. when a
+     *  handler keeps a frame as a Payload, the next read goes to a new storage.
+     */
+    class FrameReader final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        FrameReader(
+            std::uint64_t init_initial,
+            std::uint64_t init_max_payload,
+            clock::duration init_idle
+        )
+            : max_payload(init_max_payload)
+            , idle_period(init_idle)
+            , small(std::min(init_initial, init_max_payload) + utils::TCP_HEADER_SIZE)
+        {
+        }
+
+        void reset()
+        {
+            head = 0;
+            tail = 0;
+            in_large = false;
+        }
+
+        /**
+         * @brief region to read into.
+         */
+        boost::asio::mutable_buffer prepare()
+        {
+            if (head == tail)
+            {
+                reset();
+            }
+
+            if (auto& current = storage(); current.lent())
+            {
+                // a handler kept a frame, its bytes must stay untouched
+                current.relocate(current.size(), head, tail);
+                tail -= head;
+                head = 0;
+            }
+            else if (head != 0)
+            {
+                std::memmove(current.data(), current.data() + head, tail - head);
+                tail -= head;
+                head = 0;
+            }
+
+            if (tail >= utils::TCP_HEADER_SIZE)
+            {
+                // consume() already rejected frames over the maximum payload size
+                const auto frame_size = utils::TCP_HEADER_SIZE
+                    + utils::from_array<std::uint64_t>(storage().data());
+                if (frame_size > storage().size())
+                {
+                    grow(frame_size);
+                }
+            }
+
+            if (in_large)
+            {
+                last_large = clock::now();
+            }
+            else
+            {
+                release_idle();
+            }
+
+            auto& current = storage();
+            return boost::asio::buffer(current.data() + tail, current.size() - tail);
+        }
+
+        void commit(std::uint64_t count)
+        {
+            tail += count;
+        }
+
+        /**
+         * @brief calls `handler(const std::uint8_t*, std::uint64_t)` for each complete frame.
+         *  the data is only valid during the call.
+         *
+         * @return false if a frame exceeds the maximum payload size
+         */
+        template <typename Handler>
+        bool consume(Handler&& handler)
+        {
+            const auto& current = storage();
+            const auto lend = current.lend();
+            while (tail - head >= utils::TCP_HEADER_SIZE)
+            {
+                const auto size = utils::from_array<std::uint64_t>(current.data() + head);
+                if (size > max_payload)
+                {
+                    return false;
+                }
+
+                const auto frame_size = utils::TCP_HEADER_SIZE + size;
+                if (tail - head < frame_size)
+                {
+                    break;
+                }
+
+                const auto* data = current.data() + head + utils::TCP_HEADER_SIZE;
+                head += frame_size;
+                handler(data, size);
+            }
+            return true;
+        }
+
+        /**
+         * @brief releases the grown storage if it was not used for the idle period.
+         *
+         * @return true if there is no grown storage left
+         */
+        bool release_idle()
+        {
+            if (!large.empty() && !in_large && clock::now() - last_large >= idle_period)
+            {
+                large = {};
+            }
+            return large.empty();
+        }
+
+        [[nodiscard]] bool grown() const
+        {
+            return !large.empty();
+        }
+
+        [[nodiscard]] std::uint64_t max_size() const
+        {
+            return max_payload;
+        }
+
+        [[nodiscard]] clock::duration idle() const
+        {
+            return idle_period;
+        }
+
+    private:
+        std::uint64_t max_payload;
+        clock::duration idle_period;
+        ReceiveBuffer small;
+        ReceiveBuffer large;
+        clock::time_point last_large;
+        bool in_large = false;
+        std::uint64_t head = 0;
+        std::uint64_t tail = 0;
+
+        ReceiveBuffer& storage()
+        {
+            return in_large ? large : small;
+        }
+
+        void grow(std::uint64_t frame_size)
+        {
+            if (large.size() < frame_size)
+            {
+                // doubling leaves room for the frames that follow
+                const auto limit = max_payload + utils::TCP_HEADER_SIZE;
+                const auto doubled = std::max<std::uint64_t>(frame_size, 2 * large.size());
+                large.relocate(std::min(doubled, limit), 0, in_large ? tail : 0);
+            }
+            else if (!in_large && large.lent())
+            {
+                large.relocate(large.size(), 0, 0);
+            }
+
+            if (!in_large)
+            {
+                std::memcpy(large.data(), small.data(), tail);
+                in_large = true;
+            }
+        }
+    };
+}
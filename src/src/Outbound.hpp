@@ -0,0 +1,195 @@
+#pragma once
+
+#include <nil/service/backpressure.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace nil::service
+{
+    /**
+     * @brief service wide accounting of the bytes waiting to reach the peers.
+     *  covers both the payloads posted to the service thread and the
+     *  frames queued in the connections. a payload counts once: while posted
+     *  against the callers of publish/send only, once queued against the connections.
+     */
+    class Outbound final
+    {
+    public:
+        /**
+         * @brief holds the bytes of a posted payload until it is handed to the connections.
+         */
+        class Ticket final
+        {
+        public:
+            Ticket(Outbound& init_parent, std::uint64_t init_bytes)
+                : parent(&init_parent)
+                , bytes(init_bytes)
+            {
+            }
+
+            ~Ticket() noexcept
+            {
+                if (parent != nullptr)
+                {
+                    parent->remove_posted(bytes);
+                }
+            }
+
+            Ticket(Ticket&& o) noexcept
+                : parent(o.parent)
+                , bytes(o.bytes)
+            {
+                o.parent = nullptr;
+            }
+
+            Ticket& operator=(Ticket&&) = delete;
+            Ticket(const Ticket&) = delete;
+            Ticket& operator=(const Ticket&) = delete;
+
+        private:
+            Outbound* parent;
+            std::uint64_t bytes;
+        };
+
+        explicit Outbound(Backpressure init_options)
+            : options(init_options)
+        {
+        }
+
+        ~Outbound() noexcept = default;
+
+        Outbound(Outbound&&) = delete;
+        Outbound(const Outbound&) = delete;
+        Outbound& operator=(Outbound&&) = delete;
+        Outbound& operator=(const Outbound&) = delete;
+
+        [[nodiscard]] const Backpressure& limits() const
+        {
+            return options;
+        }
+
+        /**
+         * @brief called by the caller of publish/send before posting to the service thread.
+         *  waits when the policy is block (unless `in_service_thread`).
+         *
+         * @return std::nullopt if the payload should be discarded
+         */
+        [[nodiscard]] std::optional<Ticket> admit(std::uint64_t size, bool in_service_thread)
+        {
+            if (options.policy == Backpressure::Policy::block && !in_service_thread)
+            {
+                std::unique_lock lock(mutex);
+                ++waiters;
+                cv.wait(lock, [this]() { return released || !congested(); });
+                --waiters;
+            }
+            else if (options.policy == Backpressure::Policy::drop_newest
+                     && over(total() + size))
+            {
+                return std::nullopt;
+            }
+            posted.fetch_add(size, std::memory_order_relaxed);
+            return std::optional<Ticket>(std::in_place, *this, size);
+        }
+
+        /**
+         * @brief true if queuing `size` more bytes in the connections goes over the service limit.
+         *  the posted payloads are left out, the payload being queued is one of them.
+         */
+        [[nodiscard]] bool exceeds(std::uint64_t size) const
+        {
+            return over(bytes.load(std::memory_order_relaxed) + size);
+        }
+
+        void add(std::uint64_t size)
+        {
+            bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        void remove(std::uint64_t size)
+        {
+            bytes.fetch_sub(size, std::memory_order_relaxed);
+            notify();
+        }
+
+        /**
+         * @brief tracks connections that went over their own limits (block policy)
+         */
+        void stall(bool stalled)
+        {
+            if (stalled)
+            {
+                stalled_connections.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                stalled_connections.fetch_sub(1, std::memory_order_relaxed);
+                notify();
+            }
+        }
+
+        /**
+         * @brief releases (or re-arms) all blocked callers. used when stopping the service.
+         */
+        void release(bool value)
+        {
+            {
+                const std::lock_guard lock(mutex);
+                released = value;
+            }
+            cv.notify_all();
+        }
+
+    private:
+        Backpressure options;
+        // queued in the connections
+        std::atomic<std::uint64_t> bytes = 0;
+        // held by the tickets
+        std::atomic<std::uint64_t> posted = 0;
+        std::atomic<std::uint64_t> stalled_connections = 0;
+
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::uint64_t waiters = 0;
+        bool released = false;
+
+        [[nodiscard]] bool over(std::uint64_t size) const
+        {
+            return options.max_service_bytes != 0 && size > options.max_service_bytes;
+        }
+
+        [[nodiscard]] std::uint64_t total() const
+        {
+            return bytes.load(std::memory_order_relaxed) + posted.load(std::memory_order_relaxed);
+        }
+
+        void remove_posted(std::uint64_t size)
+        {
+            posted.fetch_sub(size, std::memory_order_relaxed);
+            notify();
+        }
+
+        [[nodiscard]] bool congested() const
+        {
+            return over(total()) || stalled_connections.load(std::memory_order_relaxed) > 0;
+        }
+
+        void notify()
+        {
+            if (options.policy != Backpressure::Policy::block)
+            {
+                return;
+            }
+
+            const std::lock_guard lock(mutex);
+            if (waiters > 0 && !congested())
+            {
+                cv.notify_all();
+            }
+        }
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <nil/service/ID.hpp>
+#include <nil/service/payload.hpp>
+#include <nil/service/structs.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace nil::service
+{
+    /**
+     * @brief joins the pieces of publish_some / send_some into whole messages
+     *  for the services that can not write a message in pieces.
+     *
+     *  publish_some has one open message, send_some one per set of ids, so a message
+     *  of one does not mix with the messages of the other.
+     */
+    class Pieces final
+    {
+    public:
+        void publish_some(IMessageService& service, Payload piece, bool last)
+        {
+            std::unique_lock lock(mutex);
+            auto message = join(published, std::move(piece), last);
+            lock.unlock();
+            if (message)
+            {
+                service.publish(std::move(*message));
+            }
+        }
+
+        void send_some(IMessageService& service, std::vector<ID> ids, Payload piece, bool last)
+        {
+            std::unique_lock lock(mutex);
+            auto it = std::find_if(
+                sent.begin(),
+                sent.end(),
+                [&ids](const Open& open) { return open.ids == ids; }
+            );
+            if (it == sent.end())
+            {
+                if (last)
+                {
+                    lock.unlock();
+                    service.send(std::move(ids), std::move(piece));
+                    return;
+                }
+                it = sent.insert(sent.end(), Open{.ids = ids, .data = {}});
+            }
+
+            auto message = join(it->data, std::move(piece), last);
+            if (message)
+            {
+                sent.erase(it);
+            }
+            lock.unlock();
+            if (message)
+            {
+                service.send(std::move(ids), std::move(*message));
+            }
+        }
+
+    private:
+        struct Open
+        {
+            std::vector<ID> ids;
+            std::vector<std::uint8_t> data;
+        };
+
+        std::mutex mutex;
+        std::vector<std::uint8_t> published;
+        // open messages of send_some, few at a time
+        std::vector<Open> sent;
+
+        static std::optional<Payload> join(
+            std::vector<std::uint8_t>& data,
+            Payload piece,
+            bool last
+        )
+        {
+            if (last && data.empty())
+            {
+                return piece;
+            }
+
+            data.insert(data.end(), piece.begin(), piece.end());
+            if (!last)
+            {
+                return std::nullopt;
+            }
+            return Payload(std::exchange(data, {}));
+        }
+    };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <nil/service/detail/lend.hpp>
+#include <nil/service/payload.hpp>
+#include <nil/service/pool.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace nil::service
+{
+    /**
+     * @brief storage a service receives into. the storage can be lent to the
+     *  message handlers (see detail::Lend) which may keep parts of it as Payload.
+     *  once lent and kept (`lent()`), the storage must not be written anymore:
+     *  the service continues in a new storage instead (`relocate`).
+     */
+    class ReceiveBuffer final
+    {
+    public:
+        ReceiveBuffer() = default;
+
+        explicit ReceiveBuffer(std::uint64_t size)
+            : block(allocate(size))
+            , count(size)
+        {
+        }
+
+        [[nodiscard]] std::uint8_t* data() const
+        {
+            return block.get();
+        }
+
+        [[nodiscard]] std::uint64_t size() const
+        {
+            return count;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return count == 0;
+        }
+
+        /**
+         * @return true if a payload still shares the storage
+         */
+        [[nodiscard]] bool lent() const
+        {
+            return block.use_count() > 1;
+        }
+
+        /**
+         * @brief moves to a new storage of `new_size` bytes.
+         *  the bytes in [from, to) are copied to the front of it.
+         */
+        void relocate(std::uint64_t new_size, std::uint64_t from, std::uint64_t to)
+        {
+            auto next = allocate(new_size);
+            if (to > from)
+            {
+                std::memcpy(next.get(), block.get() + from, to - from);
+            }
+            block = std::move(next);
+            count = new_size;
+        }
+
+        /**
+         * @brief lends the storage to the message handlers of the scope.
+         */
+        [[nodiscard]] detail::Lend lend() const
+        {
+            return detail::Lend(Payload::share(block, block.get(), count));
+        }
+
+    private:
+        std::shared_ptr<std::uint8_t[]> block;
+        std::uint64_t count = 0;
+
+        static std::shared_ptr<std::uint8_t[]> allocate(std::uint64_t size)
+        {
+            if (size == 0)
+            {
+                return {};
+            }
+            return pool::allocate(size);
+        }
+    };
+}
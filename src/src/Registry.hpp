@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace nil::service
+{
+    /**
+     * @brief owns the connections of a service, indexed by their address (`ID::id`).
+     *  lookup, insertion and removal are O(1). the connections are kept contiguous
+     *  for the fan-out; a removal moves the last connection into the freed slot.
+     *  the connection addresses stay stable.
+     */
+    template <typename T>
+    class Registry final
+    {
+    public:
+        T& add(std::unique_ptr<T> item)
+        {
+            auto& added = *item;
+            slots.emplace(item.get(), items.size());
+            items.push_back(std::move(item));
+            return added;
+        }
+
+        /**
+         * @return the removed item, nullptr if not found
+         */
+        std::unique_ptr<T> remove(const void* key)
+        {
+            const auto it = slots.find(key);
+            if (it == slots.end())
+            {
+                return nullptr;
+            }
+
+            const auto slot = it->second;
+            slots.erase(it);
+            auto removed = std::move(items[slot]);
+            if (slot + 1 != items.size())
+            {
+                items[slot] = std::move(items.back());
+                slots[items[slot].get()] = slot;
+            }
+            items.pop_back();
+            return removed;
+        }
+
+        [[nodiscard]] T* find(const void* key) const
+        {
+            const auto it = slots.find(key);
+            return it == slots.end() ? nullptr : items[it->second].get();
+        }
+
+        [[nodiscard]] auto begin() const
+        {
+            return items.begin();
+        }
+
+        [[nodiscard]] auto end() const
+        {
+            return items.end();
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return items.size();
+        }
+
+    private:
+        std::vector<std::unique_ptr<T>> items;
+        std::unordered_map<const void*, std::size_t> slots;
+    };
+}
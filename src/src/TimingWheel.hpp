@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace nil::service
+{
+    /**
+     * @brief hashed timing wheel. items are bucketed by the tick of their deadline
+     *  and handed back in a single sweep once due. scheduling is O(1).
+     *
+     *  deadlines past the horizon are handed back early, so the caller is expected
+     *  to check the item and reschedule it if it is not due yet.
+     */
+    template <typename T>
+    class TimingWheel final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        TimingWheel(clock::duration init_tick, clock::duration horizon)
+            : tick(std::max(init_tick, clock::duration(1)))
+            , slots(std::size_t(horizon / tick) + 2)
+            , current(ticks(clock::now()))
+        {
+        }
+
+        /**
+         * @brief schedules the item. it is handed back by the first sweep
+         *  after the deadline (at the earliest on the next tick).
+         */
+        void schedule(T* item, clock::time_point deadline)
+        {
+            const auto slot = std::clamp(ticks(deadline), current + 1, current + slots.size() - 1);
+            slots[slot % slots.size()].push_back(item);
+            ++count;
+        }
+
+        /**
+         * @brief calls `on_due(T*)` for every item due by `now`.
+         *  `on_due` may schedule items again.
+         */
+        template <typename OnDue>
+        void advance(clock::time_point now, OnDue&& on_due)
+        {
+            const auto target = ticks(now);
+            if (count == 0)
+            {
+                current = std::max(current, target);
+                return;
+            }
+
+            // after a stall, every slot is visited once and the due items sorted out by the caller
+            if (target >= current + slots.size())
+            {
+                current = target - (slots.size() - 1);
+            }
+
+            for (; current <= target; ++current)
+            {
+                auto& slot = slots[current % slots.size()];
+                due.swap(slot);
+                count -= due.size();
+                for (auto* item : due)
+                {
+                    on_due(item);
+                }
+                due.clear();
+            }
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return count == 0;
+        }
+
+        [[nodiscard]] clock::duration interval() const
+        {
+            return tick;
+        }
+
+    private:
+        clock::duration tick;
+        std::vector<std::vector<T*>> slots;
+        std::vector<T*> due;
+        std::uint64_t current;
+        std::uint64_t count = 0;
+
+        [[nodiscard]] std::uint64_t ticks(clock::time_point time) const
+        {
+            return std::uint64_t(time.time_since_epoch() / tick);
+        }
+    };
+}
@@ -43,15 +43,9 @@ namespace
         return retval;
     }
 
-    std::vector<std::uint8_t> to_payload(const void* data, std::uint64_t size)
+    nil::service::Payload to_payload(const void* data, std::uint64_t size)
     {
-        if (data == nullptr || size == 0U)
-        {
-            return {};
-        }
-
-        const auto* begin = static_cast<const std::uint8_t*>(data);
-        return {begin, begin + size};
+        return {data, size};
     }
 }
 
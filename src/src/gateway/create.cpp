@@ -20,7 +20,7 @@ namespace nil::service::gateway
         Impl& operator=(Impl&&) = delete;
         Impl& operator=(const Impl&) = delete;
 
-        void publish(std::vector<std::uint8_t> payload) override
+        void publish(Payload payload) override
         {
             for (auto* service : services)
             {
@@ -28,7 +28,7 @@ namespace nil::service::gateway
             }
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> payload) override
+        void publish_ex(std::vector<ID> ids, Payload payload) override
         {
             for (auto* service : services)
             {
@@ -36,7 +36,7 @@ namespace nil::service::gateway
             }
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> payload) override
+        void send(std::vector<ID> ids, Payload payload) override
         {
             for (auto* service : services)
             {
@@ -44,11 +44,34 @@ namespace nil::service::gateway
             }
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            for (auto* service : services)
+            {
+                service->publish_some(piece, last);
+            }
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            for (auto* service : services)
+            {
+                service->send_some(ids, piece, last);
+            }
+        }
+
         void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
         {
             on_message_handlers.push_back(std::move(handler));
         }
 
+        void impl_on_piece(
+            std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+        ) override
+        {
+            on_piece_handlers.push_back(std::move(handler));
+        }
+
         void impl_on_ready(std::function<void(ID)> handler) override
         {
             on_ready_handlers.push_back(std::move(handler));
@@ -64,10 +87,21 @@ namespace nil::service::gateway
             on_disconnect_handlers.push_back(std::move(handler));
         }
 
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_handlers.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_handlers.push_back(std::move(handler));
+        }
+
         void add_service(IEventService& service) override
         {
             services.push_back(&service);
             attach_message_forwarder(service);
+            attach_piece_forwarder(service);
             attach_event_forwarder(service, &Impl::on_ready_handlers, &IEventService::on_ready);
             attach_event_forwarder(service, &Impl::on_connect_handlers, &IEventService::on_connect);
             attach_event_forwarder(
@@ -75,6 +109,12 @@ namespace nil::service::gateway
                 &Impl::on_disconnect_handlers,
                 &IEventService::on_disconnect
             );
+            attach_event_forwarder(
+                service,
+                &Impl::on_backpressure_handlers,
+                &IEventService::on_backpressure
+            );
+            attach_event_forwarder(service, &Impl::on_drain_handlers, &IEventService::on_drain);
         }
 
         void run() override
@@ -105,14 +145,18 @@ namespace nil::service::gateway
 
     private:
         using MsgHandler = std::function<void(ID, const void*, std::uint64_t)>;
+        using PieceHandler = std::function<void(ID, const void*, std::uint64_t, Piece)>;
         using EventHandler = std::function<void(ID)>;
 
         std::vector<IEventService*> services;
         std::unique_ptr<boost::asio::io_context> context;
         std::vector<MsgHandler> on_message_handlers;
+        std::vector<PieceHandler> on_piece_handlers;
         std::vector<EventHandler> on_ready_handlers;
         std::vector<EventHandler> on_connect_handlers;
         std::vector<EventHandler> on_disconnect_handlers;
+        std::vector<EventHandler> on_backpressure_handlers;
+        std::vector<EventHandler> on_drain_handlers;
 
         static void invoke_event_handlers(const std::vector<EventHandler>& handlers, const ID& id)
         {
@@ -128,9 +172,10 @@ namespace nil::service::gateway
         static void invoke_message_handlers(
             const std::vector<MsgHandler>& handlers,
             const ID& id,
-            const std::vector<std::uint8_t>& payload
+            const Payload& payload
         )
         {
+            const auto lend = detail::Lend(payload);
             for (const auto& handler : handlers)
             {
                 if (handler)
@@ -143,17 +188,40 @@ namespace nil::service::gateway
         void attach_message_forwarder(IEventService& service)
         {
             service.on_message(
-                [this](ID id, const void* data, std::uint64_t size)
+                // shares the receive buffer of the service when it lends it
+                [this](ID id, Payload payload)
                 {
-                    const auto* start = static_cast<const std::uint8_t*>(data);
-                    const auto* end = start + size;
-                    auto payload = std::vector<std::uint8_t>(start, end);
                     this->dispatch([this, id, payload = std::move(payload)]()
                                    { invoke_message_handlers(on_message_handlers, id, payload); });
                 }
             );
         }
 
+        void attach_piece_forwarder(IEventService& service)
+        {
+            service.on_piece(
+                [this](ID id, const void* data, std::uint64_t size, Piece position)
+                {
+                    if (on_piece_handlers.empty())
+                    {
+                        return;
+                    }
+                    this->dispatch(
+                        [this, id, position, payload = Payload(data, size)]()
+                        {
+                            for (const auto& handler : on_piece_handlers)
+                            {
+                                if (handler)
+                                {
+                                    handler(id, payload.data(), payload.size(), position);
+                                }
+                            }
+                        }
+                    );
+                }
+            );
+        }
+
         void attach_event_forwarder(
             IEventService& service,
             const std::vector<EventHandler> Impl::*handlers,
@@ -2,33 +2,30 @@
 
 #include "../../utils.hpp"
 
-#include <algorithm>
+#include <unordered_set>
+#include <utility>
 
 namespace nil::service::http::server
 {
-    namespace
+    WebSocket::WebSocket(Backpressure backpressure)
+        : outbound(backpressure)
     {
-        void write_payload(ws::Connection& connection, const std::vector<std::uint8_t>& msg)
-        {
-            connection.write(msg.data(), msg.size());
-        }
+    }
 
-        [[nodiscard]] bool contains_id(const std::vector<ID>& ids, const ID& id)
-        {
-            return ids.end() != std::find(ids.begin(), ids.end(), id);
-        }
+    bool WebSocket::owns(const ID& id) const
+    {
+        // connections identify their owner through the ConnectedImpl base
+        return id.owner == static_cast<const ConnectedImpl<ws::Connection>*>(this);
+    }
 
-        [[nodiscard]] auto find_connection(
-            std::vector<std::unique_ptr<ws::Connection>>& connections,
-            const ID& id
-        )
-        {
-            return std::find_if(
-                connections.begin(),
-                connections.end(),
-                [&id](const auto& connection) { return connection->remote_id() == id; }
-            );
-        }
+    bool WebSocket::in_service_thread() const
+    {
+        return context->get_executor().running_in_this_thread();
+    }
+
+    std::optional<Outbound::Ticket> WebSocket::admit(const Payload& data)
+    {
+        return outbound.admit(data.size(), in_service_thread());
     }
 
     std::string WebSocket::to_string_local(const void* c)
@@ -54,6 +51,12 @@ namespace nil::service::http::server
     void WebSocket::message(ID id, const void* data, std::uint64_t size)
     {
         utils::invoke(on_message_cb, id, data, size);
+        utils::invoke(on_piece_cb, id, data, size, Piece{});
+    }
+
+    void WebSocket::piece(ID id, const void* data, std::uint64_t size, Piece position)
+    {
+        utils::invoke(on_piece_cb, id, data, size, position);
     }
 
     void WebSocket::disconnect(ws::Connection* connection)
@@ -63,71 +66,166 @@ namespace nil::service::http::server
             [this, id = connection->remote_id()]()
             {
                 utils::invoke(on_disconnect_cb, id);
-                connections.erase(
-                    std::remove_if(
-                        connections.begin(),
-                        connections.end(),
-                        [&id](const auto& current) { return current->remote_id() == id; }
-                    ),
-                    connections.end()
-                );
+                connections.remove(id.id);
             }
         );
     }
 
-    void WebSocket::publish(std::vector<std::uint8_t> data)
+    void WebSocket::backpressure(ws::Connection* connection)
+    {
+        utils::invoke(on_backpressure_cb, connection->remote_id());
+    }
+
+    void WebSocket::drain(ws::Connection* connection)
+    {
+        utils::invoke(on_drain_cb, connection->remote_id());
+    }
+
+    void WebSocket::publish(Payload data)
     {
-        if (context != nullptr)
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        if (auto ticket = admit(data))
         {
             boost::asio::post(
                 *context,
-                [this, msg = std::move(data)]()
+                [this, ticket = std::move(*ticket), msg = std::move(data)]()
                 {
+                    // framed once, every connection writes the same bytes
+                    const auto header = ws::frame_header(msg.size());
                     for (const auto& connection : connections)
                     {
-                        write_payload(*connection, msg);
+                        connection->write(header, msg);
                     }
                 }
             );
         }
     }
 
-    void WebSocket::publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data)
+    void WebSocket::publish_ex(std::vector<ID> ids, Payload data)
     {
-        if (context != nullptr)
+        if (context == nullptr)
         {
+            return;
+        }
+
+        if (auto ticket = admit(data))
+        {
+            std::unordered_set<const void*> excluded;
+            for (const auto& id : ids)
+            {
+                if (owns(id))
+                {
+                    excluded.emplace(id.id);
+                }
+            }
+
             boost::asio::post(
                 *context,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this,
+                 ticket = std::move(*ticket),
+                 excluded = std::move(excluded),
+                 msg = std::move(data)]()
                 {
+                    const auto header = ws::frame_header(msg.size());
                     for (const auto& connection : connections)
                     {
-                        if (contains_id(ids, connection->remote_id()))
+                        if (excluded.contains(connection.get()))
+                        {
+                            continue;
+                        }
+
+                        connection->write(header, msg);
+                    }
+                }
+            );
+        }
+    }
+
+    void WebSocket::send(std::vector<ID> ids, Payload data)
+    {
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        if (auto ticket = admit(data))
+        {
+            boost::asio::post(
+                *context,
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
+                {
+                    for (const auto& id : ids)
+                    {
+                        if (!owns(id))
                         {
                             continue;
                         }
 
-                        write_payload(*connection, msg);
+                        if (auto* connection = connections.find(id.id))
+                        {
+                            connection->write(msg);
+                        }
+                    }
+                }
+            );
+        }
+    }
+
+    void WebSocket::publish_some(Payload piece, bool last)
+    {
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        if (auto ticket = admit(piece))
+        {
+            boost::asio::post(
+                *context,
+                [this, ticket = std::move(*ticket), msg = std::move(piece), last]()
+                {
+                    // connections accepted after the first piece skip the message
+                    const auto first = !std::exchange(publishing, !last);
+                    for (const auto& connection : connections)
+                    {
+                        connection->write_some(msg, first, last);
                     }
                 }
             );
         }
     }
 
-    void WebSocket::send(std::vector<ID> ids, std::vector<std::uint8_t> data)
+    void WebSocket::send_some(std::vector<ID> ids, Payload piece, bool last)
     {
-        if (context != nullptr)
+        if (context == nullptr)
+        {
+            return;
+        }
+
+        if (auto ticket = admit(piece))
         {
             boost::asio::post(
                 *context,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this,
+                 ticket = std::move(*ticket),
+                 ids = std::move(ids),
+                 msg = std::move(piece),
+                 last]()
                 {
                     for (const auto& id : ids)
                     {
-                        auto it = find_connection(connections, id);
-                        if (it != connections.end())
+                        if (!owns(id))
+                        {
+                            continue;
+                        }
+
+                        if (auto* connection = connections.find(id.id))
                         {
-                            write_payload(**it, msg);
+                            connection->write_some(msg, true, last);
                         }
                     }
                 }
@@ -140,6 +238,13 @@ namespace nil::service::http::server
         on_message_cb.push_back(std::move(handler));
     }
 
+    void WebSocket::impl_on_piece(
+        std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+    )
+    {
+        on_piece_cb.push_back(std::move(handler));
+    }
+
     void WebSocket::impl_on_ready(std::function<void(ID)> handler)
     {
         on_ready_cb.push_back(std::move(handler));
@@ -154,4 +259,14 @@ namespace nil::service::http::server
     {
         on_disconnect_cb.push_back(std::move(handler));
     }
+
+    void WebSocket::impl_on_backpressure(std::function<void(ID)> handler)
+    {
+        on_backpressure_cb.push_back(std::move(handler));
+    }
+
+    void WebSocket::impl_on_drain(std::function<void(ID)> handler)
+    {
+        on_drain_cb.push_back(std::move(handler));
+    }
 }
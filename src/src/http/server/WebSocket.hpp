@@ -3,6 +3,8 @@
 #include <nil/service/structs.hpp>
 
 #include "../../ConnectedImpl.hpp"
+#include "../../Outbound.hpp"
+#include "../../Registry.hpp"
 #include "../../ws/Connection.hpp"
 
 namespace nil::service::http::server
@@ -15,39 +17,59 @@ namespace nil::service::http::server
         friend struct Impl;
 
     public:
-        WebSocket() = default;
+        explicit WebSocket(Backpressure backpressure);
         ~WebSocket() noexcept override = default;
         WebSocket(WebSocket&&) = delete;
         WebSocket(const WebSocket&) = delete;
         WebSocket& operator=(WebSocket&&) = delete;
         WebSocket& operator=(const WebSocket&) = delete;
 
-        void publish(std::vector<std::uint8_t> data) override;
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override;
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override;
+        void publish(Payload data) override;
+        void publish_ex(std::vector<ID> ids, Payload data) override;
+        void send(std::vector<ID> ids, Payload data) override;
+        void publish_some(Payload piece, bool last) override;
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override;
 
         void ready();
         void connect(ws::Connection* connection) override;
         void message(ID id, const void* data, std::uint64_t size) override;
+        void piece(ID id, const void* data, std::uint64_t size, Piece position) override;
         void disconnect(ws::Connection* connection) override;
+        void backpressure(ws::Connection* connection) override;
+        void drain(ws::Connection* connection) override;
 
         void set_route(std::string route);
         static std::string to_string_local(const void* c);
 
     private:
         std::string route;
-        std::vector<std::unique_ptr<ws::Connection>> connections;
+        Outbound outbound;
+        Registry<ws::Connection> connections;
+        // a message of publish_some is open (service thread)
+        bool publishing = false;
 
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID, const void*, std::uint64_t, Piece)>> on_piece_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
+
+        [[nodiscard]] bool owns(const ID& id) const;
+        [[nodiscard]] bool in_service_thread() const;
+        [[nodiscard]] std::optional<Outbound::Ticket> admit(const Payload& data);
 
         // clang-format off
         void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override;
+        void impl_on_piece(
+            std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+        ) override;
         void impl_on_ready(std::function<void(ID)> handler) override;
         void impl_on_connect(std::function<void(ID)> handler) override;
         void impl_on_disconnect(std::function<void(ID)> handler) override;
+        void impl_on_backpressure(std::function<void(ID)> handler) override;
+        void impl_on_drain(std::function<void(ID)> handler) override;
         // clang-format on
 
         boost::asio::io_context* context = nullptr;
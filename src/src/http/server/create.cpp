@@ -2,6 +2,7 @@
 
 #include "../../structs/WebTransaction.hpp"
 #include "../../utils.hpp"
+#include "../../ws/Deflate.hpp"
 #include "WebSocket.hpp"
 
 #include <boost/asio/executor_work_guard.hpp>
@@ -14,6 +15,9 @@
 #include <boost/beast/http/read.hpp>
 #include <boost/beast/http/write.hpp>
 
+#include <chrono>
+#include <limits>
+
 namespace nil::service::http::server
 {
     struct Context final
@@ -67,7 +71,7 @@ namespace nil::service::http::server
 
         IEventService* use_ws(const std::string& key) override
         {
-            return &wss[key];
+            return &wss.try_emplace(key, options.backpressure).first->second;
         }
 
         void run() override;
@@ -98,6 +102,9 @@ namespace nil::service::http::server
 
     struct Transaction final: public std::enable_shared_from_this<Transaction>
     {
+        // time given to receive a request and to write its response
+        static constexpr auto REQUEST_TIMEOUT = std::chrono::seconds(60);
+
         explicit Transaction(
             Impl& init_parent,
             std::uint64_t init_buffer,
@@ -106,27 +113,48 @@ namespace nil::service::http::server
             : parent(init_parent)
             , socket(std::move(init_socket))
             , buffer(init_buffer)
-            , deadline(socket.get_executor(), std::chrono::seconds(60))
+            , deadline(socket.get_executor())
         {
         }
 
         void run()
         {
-            auto self = shared_from_this();
+            read_request(REQUEST_TIMEOUT);
+        }
+
+        /**
+         * @brief reads the next request of the connection.
+         *  pipelined requests are already in `buffer` and are handled one after the other,
+         *  each response is written before the next request is read.
+         */
+        void read_request(std::chrono::steady_clock::duration timeout)
+        {
+            request = {};
+            response = {};
+            arm(timeout);
             boost::beast::http::async_read(
                 socket,
                 buffer,
                 request,
-                [self](boost::beast::error_code ec, std::size_t /* bytes_transferred */)
+                [self = shared_from_this()](boost::beast::error_code ec, std::size_t)
                 {
-                    if (!ec)
+                    if (ec)
                     {
-                        self->process_request();
+                        self->deadline.cancel();
+                        return;
                     }
+                    self->arm(REQUEST_TIMEOUT);
+                    self->process_request();
                 }
             );
+        }
+
+        // closes the socket if the current step is not done after `timeout`
+        void arm(std::chrono::steady_clock::duration timeout)
+        {
+            deadline.expires_after(timeout);
             deadline.async_wait(
-                [self](boost::beast::error_code ec)
+                [self = shared_from_this()](boost::beast::error_code ec)
                 {
                     if (!ec)
                     {
@@ -144,6 +172,7 @@ namespace nil::service::http::server
         boost::beast::http::response<boost::beast::http::dynamic_body> response;
 
         boost::asio::steady_timer deadline;
+        std::uint64_t served = 0;
 
         [[nodiscard]] bool handle_ws(http::server::WebSocket& websocket)
         {
@@ -151,8 +180,10 @@ namespace nil::service::http::server
             namespace bbws = bb::websocket;
             if (bbws::is_upgrade(request))
             {
-                auto ws = std::make_unique<bbws::stream<bb::tcp_stream>>(std::move(socket));
+                const auto& compression = parent.options.compression;
+                auto ws = std::make_unique<service::ws::Stream>(std::move(socket));
                 ws->set_option(bbws::stream_base::timeout::suggested(bb::role_type::server));
+                ws->set_option(service::ws::deflate_option(compression, bb::role_type::server));
                 ws->set_option(bbws::stream_base::decorator(
                     [](bbws::response_type& res)
                     {
@@ -169,23 +200,40 @@ namespace nil::service::http::server
                     }
                 ));
 
+                // compressed connections frame the messages under the threshold only
+                constexpr auto ALL = std::numeric_limits<std::uint64_t>::max();
+                const auto compressed = service::ws::negotiates_deflate(compression, request);
+                const auto frame_below = compressed ? compression.threshold : ALL;
                 auto* ws_ptr = ws.get();
                 ws_ptr->async_accept(
                     request,
-                    [&websocket, s = buffer.max_size(), ws = std::move(ws)] //
-                    (bb::error_code ec)
+                    [&websocket,
+                     s = buffer.max_size(),
+                     ws = std::move(ws),
+                     frame_below,
+                     compressed,
+                     stream = parent.options.stream](bb::error_code ec)
                     {
                         if (ec)
                         {
                             return;
                         }
 
-                        auto connection
-                            = std::make_unique<ws::Connection>(s, std::move(*ws), websocket);
+                        auto connection = std::make_unique<ws::Connection>(
+                            s,
+                            std::move(*ws),
+                            websocket,
+                            websocket.outbound,
+                            frame_below,
+                            compressed,
+                            stream
+                        );
                         connection->run();
-                        websocket.connections.push_back(std::move(connection));
+                        websocket.connections.add(std::move(connection));
                     }
                 );
+                // the socket belongs to the websocket now
+                deadline.cancel();
                 return true;
             }
 
@@ -195,7 +243,6 @@ namespace nil::service::http::server
         void process_request()
         {
             response.version(request.version());
-            response.keep_alive(false);
 
             switch (request.method())
             {
@@ -242,6 +289,12 @@ namespace nil::service::http::server
 
         void write_response()
         {
+            const auto& options = parent.options;
+            ++served;
+            response.keep_alive(
+                request.keep_alive() && options.keep_alive_ms > 0
+                && (options.max_requests == 0 || served < options.max_requests)
+            );
             response.content_length(response.body().size());
 
             boost::beast::http::async_write(
@@ -251,6 +304,13 @@ namespace nil::service::http::server
                 {
                     if (ec)
                     {
+                        self->deadline.cancel();
+                        return;
+                    }
+                    if (self->response.keep_alive())
+                    {
+                        const auto idle = self->parent.options.keep_alive_ms;
+                        self->read_request(std::chrono::milliseconds(idle));
                         return;
                     }
                     self->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
@@ -273,11 +333,19 @@ namespace nil::service::http::server
 
     void Impl::stop()
     {
+        for (auto& [route, ws] : wss)
+        {
+            ws.outbound.release(true);
+        }
         context->ctx.stop();
     }
 
     void Impl::restart()
     {
+        for (auto& [route, ws] : wss)
+        {
+            ws.outbound.release(false);
+        }
         context = std::make_unique<Context>(options.host, options.port);
         boost::asio::post(
             context->ctx,
@@ -0,0 +1,36 @@
+#include <nil/service/detail/lend.hpp>
+
+namespace nil::service::detail
+{
+    namespace
+    {
+        thread_local const Lend* current = nullptr; // NOLINT
+    }
+
+    Lend::Lend(Payload init_buffer)
+        : buffer(std::move(init_buffer))
+        , previous(current)
+    {
+        current = this;
+    }
+
+    Lend::~Lend() noexcept
+    {
+        current = previous;
+    }
+
+    Payload Lend::adopt(const void* data, std::uint64_t size)
+    {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        // scopes nest when a handler delivers to another service (e.g. self)
+        for (const auto* lend = current; lend != nullptr && size > 0; lend = lend->previous)
+        {
+            const auto& lent = lend->buffer;
+            if (lent.data() <= bytes && bytes + size <= lent.end())
+            {
+                return lent.slice(std::uint64_t(bytes - lent.data()), size);
+            }
+        }
+        return Payload(data, size);
+    }
+}
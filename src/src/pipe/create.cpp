@@ -1,5 +1,7 @@
 #include <nil/service/pipe/create.hpp>
 
+#include "../FrameReader.hpp"
+#include "../Pieces.hpp"
 #include "../utils.hpp"
 
 #include <boost/asio/executor_work_guard.hpp>
@@ -125,7 +127,7 @@ namespace nil::service::pipe
             boost::asio::post(context->ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
             if (!context->writer)
             {
@@ -138,7 +140,7 @@ namespace nil::service::pipe
             );
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
             if (!context->writer)
             {
@@ -157,7 +159,7 @@ namespace nil::service::pipe
             );
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
             if (!context->writer)
             {
@@ -176,12 +178,23 @@ namespace nil::service::pipe
             );
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
     private:
         Options options;
+        Pieces pieces;
         std::unique_ptr<Context> context;
         int read_fd = NO_FD;
         int write_fd = NO_FD;
-        std::vector<std::uint8_t> r_buffer;
+        std::optional<FrameReader> r_frames;
         bool ready_notified = false;
         bool connected = false;
         bool read_loop_active = false;
@@ -296,8 +309,12 @@ namespace nil::service::pipe
             if (context->reader && !read_loop_active)
             {
                 read_loop_active = true;
-                r_buffer.resize(options.buffer + utils::TCP_HEADER_SIZE);
-                read_next_header();
+                r_frames.emplace(
+                    options.buffer_initial,
+                    options.buffer,
+                    std::chrono::milliseconds(options.buffer_idle_ms)
+                );
+                read();
             }
         }
 
@@ -355,11 +372,6 @@ namespace nil::service::pipe
             return true;
         }
 
-        void read_next_header()
-        {
-            readHeader(utils::START_INDEX, utils::TCP_HEADER_SIZE);
-        }
-
         bool reconnect_read(bool should_notify_ready)
         {
             cancel_timers();
@@ -463,7 +475,7 @@ namespace nil::service::pipe
             return !ec;
         }
 
-        void readHeader(std::uint64_t pos, std::uint64_t size)
+        void read()
         {
             if (!context->reader)
             {
@@ -471,10 +483,10 @@ namespace nil::service::pipe
             }
 
             context->reader->async_read_some(
-                boost::asio::buffer(r_buffer.data() + pos, size - pos),
-                [pos, size, this](const boost::system::error_code& ec, std::size_t count)
+                r_frames->prepare(),
+                [this](const boost::system::error_code& ec, std::size_t count)
                 {
-                    if (handle_read_error(ec, [this, pos, size]() { readHeader(pos, size); }))
+                    if (handle_read_error(ec, [this]() { read(); }))
                     {
                         return;
                     }
@@ -484,67 +496,31 @@ namespace nil::service::pipe
                         return;
                     }
 
-                    if (pos + count != size)
-                    {
-                        readHeader(pos + count, size);
-                        return;
-                    }
-
-                    if (!connected)
-                    {
-                        utils::invoke(on_connect_cb, self_id());
-                        connected = true;
-                        // Don't cancel probe - keep sending until both sides see connection
-                    }
-
-                    const auto payload_size = utils::from_array<std::uint64_t>(r_buffer.data());
-                    if (payload_size == 0)
-                    {
-                        read_next_header();
-                        return;
-                    }
-
-                    readBody(utils::START_INDEX, payload_size);
-                }
-            );
-        }
-
-        void readBody(std::uint64_t pos, std::uint64_t size)
-        {
-            if (!context->reader)
-            {
-                return;
-            }
-
-            if (size > options.buffer)
-            {
-                handle_read_disconnect();
-                return;
-            }
-
-            context->reader->async_read_some(
-                boost::asio::buffer(r_buffer.data() + pos, size - pos),
-                [pos, size, this](const boost::system::error_code& ec, std::size_t count)
-                {
-                    if (handle_read_error(ec, [this, pos, size]() { readBody(pos, size); }))
-                    {
-                        return;
-                    }
-
-                    if (handle_empty_read(count))
+                    r_frames->commit(count);
+                    const auto valid = r_frames->consume(
+                        [this](const std::uint8_t* data, std::uint64_t size)
+                        {
+                            if (!connected)
+                            {
+                                utils::invoke(on_connect_cb, self_id());
+                                connected = true;
+                                // Don't cancel probe - keep sending until both sides see connection
+                            }
+
+                            if (size > 0)
+                            {
+                                utils::invoke(on_message_cb, self_id(), data, size);
+                            }
+                        }
+                    );
+
+                    if (!valid)
                     {
+                        handle_read_disconnect();
                         return;
                     }
 
-                    if (pos + count != size)
-                    {
-                        readBody(pos + count, size);
-                    }
-                    else
-                    {
-                        utils::invoke(on_message_cb, self_id(), r_buffer.data(), size);
-                        read_next_header();
-                    }
+                    read();
                 }
             );
         }
@@ -0,0 +1,278 @@
+#include <nil/service/pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <vector>
+
+namespace nil::service::pool
+{
+    namespace
+    {
+        constexpr std::uint64_t SMALLEST_CLASS = 64;
+        // 64B, 128B, ... 1MiB
+        constexpr std::size_t CLASSES = 15;
+        // bytes a thread keeps per class (at least 2 / at most 512 buffers)
+        constexpr std::uint64_t THREAD_BYTES = 256 * 1024;
+        // the shared cache keeps more for the threads that only allocate or only release
+        constexpr std::uint64_t SHARED_FACTOR = 4;
+
+        std::size_t class_of(std::uint64_t size)
+        {
+            if (size <= SMALLEST_CLASS)
+            {
+                return 0;
+            }
+            return std::size_t(std::bit_width(size - 1) - std::bit_width(SMALLEST_CLASS - 1));
+        }
+
+        std::uint64_t class_size(std::size_t index)
+        {
+            return SMALLEST_CLASS << index;
+        }
+
+        std::size_t thread_limit(std::size_t index)
+        {
+            return std::size_t(std::clamp<std::uint64_t>(THREAD_BYTES / class_size(index), 2, 512));
+        }
+
+        // updated by the owning thread only, read by `stats()`
+        void bump(std::atomic<std::uint64_t>& counter, std::int64_t delta)
+        {
+            counter.store(
+                counter.load(std::memory_order_relaxed) + std::uint64_t(delta),
+                std::memory_order_relaxed
+            );
+        }
+
+        struct Cache;
+
+        struct Shared final
+        {
+            std::mutex mutex;
+            std::vector<Cache*> caches;
+            // grown on demand, up to SHARED_FACTOR * thread_limit
+            std::array<std::vector<void*>, CLASSES> free;
+            // counters of the threads that exited
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+        };
+
+        Shared& shared()
+        {
+            // never destroyed: buffers can be released while the statics are destroyed
+            static auto* instance = new Shared(); // NOLINT
+            return *instance;
+        }
+
+        // set once the cache of the thread is destroyed, buffers then bypass the pool
+        thread_local bool exited = false; // NOLINT
+
+        struct Cache final
+        {
+            // grown on demand, up to thread_limit
+            std::array<std::vector<void*>, CLASSES> free;
+            std::atomic<std::uint64_t> hits = 0;
+            std::atomic<std::uint64_t> misses = 0;
+            std::atomic<std::uint64_t> cached = 0;
+            std::atomic<std::uint64_t> cached_bytes = 0;
+
+            Cache()
+            {
+                auto& s = shared();
+                const std::lock_guard _(s.mutex);
+                s.caches.push_back(this);
+            }
+
+            ~Cache() noexcept
+            {
+                exited = true;
+                auto& s = shared();
+                const std::lock_guard _(s.mutex);
+                for (std::size_t i = 0; i < CLASSES; ++i)
+                {
+                    give(s, i, free[i].size());
+                }
+                s.hits += hits.load(std::memory_order_relaxed);
+                s.misses += misses.load(std::memory_order_relaxed);
+                s.caches.erase(std::find(s.caches.begin(), s.caches.end(), this));
+            }
+
+            Cache(Cache&&) noexcept = delete;
+            Cache(const Cache&) = delete;
+            Cache& operator=(Cache&&) noexcept = delete;
+            Cache& operator=(const Cache&) = delete;
+
+            void* pop(std::size_t index)
+            {
+                auto& list = free[index];
+                if (list.empty())
+                {
+                    take(index);
+                }
+                if (list.empty())
+                {
+                    bump(misses, 1);
+                    return nullptr;
+                }
+
+                auto* memory = list.back();
+                list.pop_back();
+                bump(hits, 1);
+                bump(cached, -1);
+                bump(cached_bytes, -std::int64_t(class_size(index)));
+                return memory;
+            }
+
+            void push(std::size_t index, void* memory)
+            {
+                auto& list = free[index];
+                if (list.size() >= thread_limit(index))
+                {
+                    auto& s = shared();
+                    const std::lock_guard _(s.mutex);
+                    give(s, index, list.size() / 2);
+                }
+                list.push_back(memory);
+                bump(cached, 1);
+                bump(cached_bytes, std::int64_t(class_size(index)));
+            }
+
+            // refills half of the thread cache from the shared one
+            void take(std::size_t index)
+            {
+                auto& s = shared();
+                const std::lock_guard _(s.mutex);
+                auto& from = s.free[index];
+                auto& to = free[index];
+                const auto count = std::min(from.size(), thread_limit(index) / 2);
+                to.insert(to.end(), from.end() - std::ptrdiff_t(count), from.end());
+                from.resize(from.size() - count);
+                bump(cached, std::int64_t(count));
+                bump(cached_bytes, std::int64_t(count * class_size(index)));
+            }
+
+            // moves `count` buffers to the shared cache, frees what it can not keep
+            void give(Shared& s, std::size_t index, std::size_t count)
+            {
+                auto& list = free[index];
+                auto& to = s.free[index];
+                const auto limit = SHARED_FACTOR * thread_limit(index);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    if (to.size() < limit)
+                    {
+                        to.push_back(list.back());
+                    }
+                    else
+                    {
+                        ::operator delete(list.back());
+                    }
+                    list.pop_back();
+                }
+                bump(cached, -std::int64_t(count));
+                bump(cached_bytes, -std::int64_t(count * class_size(index)));
+            }
+        };
+
+        Cache* local()
+        {
+            if (exited)
+            {
+                return nullptr;
+            }
+            thread_local Cache cache; // NOLINT
+            return &cache;
+        }
+    }
+
+    void* acquire(std::uint64_t size)
+    {
+        const auto index = class_of(size);
+        if (index >= CLASSES)
+        {
+            if (auto* cache = local())
+            {
+                bump(cache->misses, 1);
+            }
+            return ::operator new(size);
+        }
+
+        if (auto* cache = local())
+        {
+            if (auto* memory = cache->pop(index))
+            {
+                return memory;
+            }
+        }
+        return ::operator new(class_size(index));
+    }
+
+    void release(void* memory, std::uint64_t size) noexcept
+    {
+        if (memory == nullptr)
+        {
+            return;
+        }
+
+        const auto index = class_of(size);
+        auto* cache = index < CLASSES ? local() : nullptr;
+        if (cache == nullptr)
+        {
+            ::operator delete(memory);
+            return;
+        }
+        cache->push(index, memory);
+    }
+
+    Stats stats()
+    {
+        auto& s = shared();
+        const std::lock_guard _(s.mutex);
+        Stats retval{.hits = s.hits, .misses = s.misses};
+        for (std::size_t i = 0; i < CLASSES; ++i)
+        {
+            retval.cached += s.free[i].size();
+            retval.cached_bytes += s.free[i].size() * class_size(i);
+        }
+        for (const auto* cache : s.caches)
+        {
+            retval.hits += cache->hits.load(std::memory_order_relaxed);
+            retval.misses += cache->misses.load(std::memory_order_relaxed);
+            retval.cached += cache->cached.load(std::memory_order_relaxed);
+            retval.cached_bytes += cache->cached_bytes.load(std::memory_order_relaxed);
+        }
+        return retval;
+    }
+
+    void trim()
+    {
+        if (auto* cache = local())
+        {
+            for (std::size_t i = 0; i < CLASSES; ++i)
+            {
+                auto& list = cache->free[i];
+                for (auto* memory : list)
+                {
+                    ::operator delete(memory);
+                }
+                bump(cache->cached, -std::int64_t(list.size()));
+                bump(cache->cached_bytes, -std::int64_t(list.size() * class_size(i)));
+                list.clear();
+            }
+        }
+
+        auto& s = shared();
+        const std::lock_guard _(s.mutex);
+        for (auto& list : s.free)
+        {
+            for (auto* memory : list)
+            {
+                ::operator delete(memory);
+            }
+            list.clear();
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <nil/service/self/create.hpp>
 
+#include "../Pieces.hpp"
 #include "../utils.hpp"
 
 #include <boost/asio/io_context.hpp>
@@ -32,12 +33,12 @@ namespace nil::service::self
             );
         }
 
-        void publish(std::vector<std::uint8_t> payload) override
+        void publish(Payload payload) override
         {
             queue_self_message(std::move(payload));
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> payload) override
+        void publish_ex(std::vector<ID> ids, Payload payload) override
         {
             boost::asio::post(
                 *context,
@@ -52,7 +53,7 @@ namespace nil::service::self
             );
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
             boost::asio::post(
                 *context,
@@ -67,6 +68,16 @@ namespace nil::service::self
             );
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
         void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
         {
             on_message_cb.push_back(std::move(handler));
@@ -133,18 +144,20 @@ namespace nil::service::self
             return ids.end() != std::find(ids.begin(), ids.end(), self_id());
         }
 
-        void emit_self_message(const std::vector<std::uint8_t>& msg)
+        void emit_self_message(const Payload& msg)
         {
             const auto id = self_id();
+            const auto lend = detail::Lend(msg);
             utils::invoke(on_message_cb, id, msg.data(), msg.size());
         }
 
-        void queue_self_message(std::vector<std::uint8_t> msg)
+        void queue_self_message(Payload msg)
         {
             boost::asio::post(*context, [this, msg = std::move(msg)]() { emit_self_message(msg); });
         }
 
         std::unique_ptr<boost::asio::io_context> context;
+        Pieces pieces;
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace nil::service::shm
+{
+    // avoids false sharing between the producer and the consumer positions
+    constexpr std::size_t CACHE_LINE = 64;
+
+    /**
+     * @brief futex word to sleep on until the other side makes progress.
+     *  `sequence` is bumped on every signal, `waiters` tells whether a wake up is needed.
+     */
+    struct Doorbell final
+    {
+        std::atomic<std::uint32_t> sequence;
+        std::atomic<std::uint32_t> waiters;
+    };
+
+    /**
+     * @brief shared state of a ring, lives in the shared memory next to the ring data.
+     *  positions only grow, the offset in the data is `position % capacity`.
+     */
+    struct RingState final
+    {
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> head;
+        alignas(CACHE_LINE) std::atomic<std::uint64_t> tail;
+        // rung by the producer when a message was written
+        alignas(CACHE_LINE) Doorbell readable;
+        // rung by the consumer when room was made
+        Doorbell writable;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    /**
+     * @brief single producer / single consumer ring of messages.
+     *
+     *  a record is a size (u64) followed by the payload, padded to 8 bytes.
+     *  a record never wraps: when it does not fit before the end of the data,
+     *  a skip record fills the end and the record starts over at the beginning.
+     *  the consumer reads the payloads in place.
+     *
+     *  the producer only writes `tail`, the consumer only writes `head`.
+     */
+    class Ring final
+    {
+    public:
+        static constexpr std::uint64_t RECORD_HEADER_SIZE = sizeof(std::uint64_t);
+        static constexpr std::uint64_t SKIP = std::numeric_limits<std::uint64_t>::max();
+
+        /**
+         * @param capacity power of 2, multiple of RECORD_HEADER_SIZE
+         */
+        Ring(RingState& init_state, std::uint8_t* init_data, std::uint64_t init_capacity)
+            : state(&init_state)
+            , data(init_data)
+            , capacity(init_capacity)
+        {
+        }
+
+        /**
+         * @brief largest payload that is guaranteed to fit once the ring is drained
+         */
+        [[nodiscard]] static std::uint64_t max_payload(std::uint64_t capacity)
+        {
+            return capacity / 2 - RECORD_HEADER_SIZE;
+        }
+
+        /**
+         * @return false if there is not enough room, nothing is written
+         */
+        bool write(const void* payload, std::uint64_t size)
+        {
+            const auto record = record_size(size);
+            const auto tail = state->tail.load(std::memory_order_relaxed);
+            const auto head = state->head.load(std::memory_order_acquire);
+            const auto offset = tail % capacity;
+            const auto until_end = capacity - offset;
+            const auto skipped = until_end < record ? until_end : 0;
+            if (capacity - (tail - head) < skipped + record)
+            {
+                return false;
+            }
+
+            auto position = tail;
+            if (skipped != 0)
+            {
+                put_header(offset, SKIP);
+                position += skipped;
+            }
+
+            const auto at = position % capacity;
+            put_header(at, size);
+            if (size > 0)
+            {
+                std::memcpy(data + at + RECORD_HEADER_SIZE, payload, size);
+            }
+            state->tail.store(position + record, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief calls `handler(const std::uint8_t*, std::uint64_t)` for each message
+         *  written so far, up to `limit` messages. the data is only valid during the call.
+         *
+         * @return number of messages read
+         */
+        template <typename Handler>
+        std::uint64_t read(Handler&& handler, std::uint64_t limit)
+        {
+            auto head = state->head.load(std::memory_order_relaxed);
+            const auto tail = state->tail.load(std::memory_order_acquire);
+            std::uint64_t count = 0;
+            while (head != tail && count < limit)
+            {
+                const auto offset = head % capacity;
+                const auto size = get_header(offset);
+                if (size == SKIP)
+                {
+                    head += capacity - offset;
+                    continue;
+                }
+
+                handler(data + offset + RECORD_HEADER_SIZE, size);
+                head += record_size(size);
+                // room is given back message by message so that a waiting producer resumes
+                state->head.store(head, std::memory_order_release);
+                ++count;
+            }
+            state->head.store(head, std::memory_order_release);
+            return count;
+        }
+
+        /**
+         * @brief drops everything written so far (consumer side)
+         */
+        void discard()
+        {
+            const auto tail = state->tail.load(std::memory_order_acquire);
+            state->head.store(tail, std::memory_order_release);
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return state->head.load(std::memory_order_acquire)
+                == state->tail.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] RingState& shared() const
+        {
+            return *state;
+        }
+
+    private:
+        RingState* state;
+        std::uint8_t* data;
+        std::uint64_t capacity;
+
+        static std::uint64_t record_size(std::uint64_t size)
+        {
+            const auto unpadded = RECORD_HEADER_SIZE + size;
+            return (unpadded + RECORD_HEADER_SIZE - 1) / RECORD_HEADER_SIZE * RECORD_HEADER_SIZE;
+        }
+
+        void put_header(std::uint64_t offset, std::uint64_t size)
+        {
+            std::memcpy(data + offset, &size, sizeof(size));
+        }
+
+        [[nodiscard]] std::uint64_t get_header(std::uint64_t offset) const
+        {
+            std::uint64_t size = 0;
+            std::memcpy(&size, data + offset, sizeof(size));
+            return size;
+        }
+    };
+}
@@ -0,0 +1,659 @@
+#include <nil/service/shm/create.hpp>
+
+#include "../Pieces.hpp"
+#include "../utils.hpp"
+#include "Ring.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <mutex>
+#include <new>
+#include <thread>
+
+namespace nil::service::shm
+{
+    namespace
+    {
+        constexpr std::uint32_t MAGIC = 0x6e696c73;
+        constexpr std::uint32_t VERSION = 1;
+        constexpr std::uint64_t MIN_CAPACITY = 4096;
+        // messages read before looking at the rest (dispatched tasks, peer)
+        constexpr std::uint64_t MAX_READS = 64;
+        // interval of the attach retries and of the peer liveness checks
+        constexpr auto CHECK_INTERVAL = std::chrono::milliseconds(utils::PROBE_INTERVAL_MS);
+
+        /**
+         * @brief a side of the channel, claimed by the service attached to it
+         */
+        struct Side final
+        {
+            // pid of the process, 0 when free
+            std::atomic<std::int32_t> owner;
+            // the service reads its ring, messages can be sent to it
+            std::atomic<std::uint32_t> ready;
+        };
+
+        /**
+         * @brief layout of the shared memory object: Segment | data of ring 0 | data of ring 1
+         *  the service attached to side `i` writes to ring `i` and reads ring `1 - i`.
+         */
+        struct Segment final
+        {
+            std::atomic<std::uint32_t> magic;
+            std::uint32_t version;
+            std::uint64_t capacity;
+            Side sides[2];
+            RingState rings[2];
+        };
+
+        std::uint64_t segment_size(std::uint64_t capacity)
+        {
+            return sizeof(Segment) + 2 * capacity;
+        }
+
+        // not FUTEX_PRIVATE_FLAG: the word is shared with another process
+        void futex_wait(
+            std::atomic<std::uint32_t>& word,
+            std::uint32_t expected,
+            std::chrono::nanoseconds timeout
+        )
+        {
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            const ::timespec ts{seconds.count(), (timeout - seconds).count()};
+            auto* address = reinterpret_cast<std::uint32_t*>(&word);
+            ::syscall(SYS_futex, address, FUTEX_WAIT, expected, &ts, nullptr, 0);
+        }
+
+        void futex_wake(std::atomic<std::uint32_t>& word)
+        {
+            auto* address = reinterpret_cast<std::uint32_t*>(&word);
+            ::syscall(SYS_futex, address, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        /**
+         * @brief sleeps until the doorbell is rung or the timeout expires,
+         *  unless `ready()` is already true.
+         */
+        template <typename Ready>
+        void wait(Doorbell& bell, Ready&& ready, std::chrono::nanoseconds timeout)
+        {
+            bell.waiters.fetch_add(1);
+            const auto sequence = bell.sequence.load();
+            if (!ready())
+            {
+                futex_wait(bell.sequence, sequence, timeout);
+            }
+            bell.waiters.fetch_sub(1);
+        }
+
+        void notify(Doorbell& bell)
+        {
+            bell.sequence.fetch_add(1);
+            if (bell.waiters.load() != 0)
+            {
+                futex_wake(bell.sequence);
+            }
+        }
+
+        bool alive(std::int32_t pid)
+        {
+            return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+        }
+    }
+
+    /**
+     * @brief the shared memory object, mapped, with one of its sides claimed.
+     *  the side is released when destroyed.
+     */
+    class Mapping final
+    {
+    public:
+        /**
+         * @return nullptr if the object can not be used yet (being created, both sides taken)
+         */
+        static std::shared_ptr<Mapping> attach(const Options& options)
+        {
+            auto fd = ::shm_open(options.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+            const auto creating = fd >= 0;
+            if (!creating)
+            {
+                fd = ::shm_open(options.name.c_str(), O_RDWR, 0);
+            }
+
+            if (fd < 0)
+            {
+                return nullptr;
+            }
+
+            auto* segment = creating ? create(fd, options) : open(fd);
+            if (segment == nullptr)
+            {
+                if (creating)
+                {
+                    ::shm_unlink(options.name.c_str());
+                }
+                ::close(fd);
+                return nullptr;
+            }
+
+            const auto pid = std::int32_t(::getpid());
+            for (std::size_t side = 0; side < 2; ++side)
+            {
+                auto& owner = segment->sides[side].owner;
+                auto current = owner.load();
+                // a side left behind by a process that is gone is taken over
+                const auto free = current == 0 || !alive(current);
+                if (free && owner.compare_exchange_strong(current, pid))
+                {
+                    return std::make_shared<Mapping>(options.name, fd, segment, side);
+                }
+            }
+
+            ::munmap(segment, segment_size(segment->capacity));
+            ::close(fd);
+            return nullptr;
+        }
+
+        Mapping(std::string init_name, int init_fd, Segment* init_segment, std::size_t init_side)
+            : name(std::move(init_name))
+            , fd(init_fd)
+            , segment(init_segment)
+            , side(init_side)
+            , tx(segment->rings[side], data(side), segment->capacity)
+            , rx(segment->rings[1 - side], data(1 - side), segment->capacity)
+        {
+            // whatever is left was meant for the previous owner of the side
+            rx.discard();
+            segment->sides[side].ready.store(1);
+            notify(tx.shared().readable);
+        }
+
+        ~Mapping() noexcept
+        {
+            segment->sides[side].ready.store(0);
+            segment->sides[side].owner.store(0);
+            // wakes up the peer so that it notices
+            notify(tx.shared().readable);
+            notify(rx.shared().writable);
+            // an orphaned object is no longer the one with that name
+            if (segment->sides[1 - side].owner.load() == 0 && !orphaned())
+            {
+                ::shm_unlink(name.c_str());
+            }
+            ::munmap(segment, segment_size(segment->capacity));
+            ::close(fd);
+        }
+
+        Mapping(Mapping&&) noexcept = delete;
+        Mapping(const Mapping&) = delete;
+        Mapping& operator=(Mapping&&) noexcept = delete;
+        Mapping& operator=(const Mapping&) = delete;
+
+        [[nodiscard]] Side& peer() const
+        {
+            return segment->sides[1 - side];
+        }
+
+        [[nodiscard]] std::uint64_t max_payload() const
+        {
+            return Ring::max_payload(segment->capacity);
+        }
+
+        /**
+         * @return true if the object was removed while mapped, the peer will never show up
+         */
+        [[nodiscard]] bool orphaned() const
+        {
+            struct stat info
+            {
+            };
+
+            return ::fstat(fd, &info) == 0 && info.st_nlink == 0;
+        }
+
+        // written by the publishers, one at a time
+        Ring& output()
+        {
+            return tx;
+        }
+
+        // read by the service thread
+        Ring& input()
+        {
+            return rx;
+        }
+
+    private:
+        std::string name;
+        int fd;
+        Segment* segment;
+        std::size_t side;
+        Ring tx;
+        Ring rx;
+
+        std::uint8_t* data(std::size_t ring) const
+        {
+            return reinterpret_cast<std::uint8_t*>(segment + 1) + ring * segment->capacity;
+        }
+
+        static Segment* map(int fd, std::uint64_t size)
+        {
+            auto* address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            return address == MAP_FAILED ? nullptr : static_cast<Segment*>(address);
+        }
+
+        static Segment* create(int fd, const Options& options)
+        {
+            const auto capacity = std::bit_ceil(std::max(options.capacity, MIN_CAPACITY));
+            if (::ftruncate(fd, off_t(segment_size(capacity))) != 0)
+            {
+                return nullptr;
+            }
+
+            auto* segment = map(fd, segment_size(capacity));
+            if (segment != nullptr)
+            {
+                // the object is zero filled, which is the initial state of every field
+                new (segment) Segment();
+                segment->version = VERSION;
+                segment->capacity = capacity;
+                segment->magic.store(MAGIC, std::memory_order_release);
+            }
+            return segment;
+        }
+
+        static Segment* open(int fd)
+        {
+            struct stat info
+            {
+            };
+
+            if (::fstat(fd, &info) != 0 || std::uint64_t(info.st_size) < sizeof(Segment))
+            {
+                return nullptr;
+            }
+
+            const auto size = std::uint64_t(info.st_size);
+            auto* segment = map(fd, size);
+            if (segment == nullptr)
+            {
+                return nullptr;
+            }
+
+            if (segment->magic.load(std::memory_order_acquire) != MAGIC
+                || segment->version != VERSION || segment_size(segment->capacity) != size)
+            {
+                ::munmap(segment, size);
+                return nullptr;
+            }
+            return segment;
+        }
+    };
+
+    struct Impl final: IStandaloneService
+    {
+        using clock = std::chrono::steady_clock;
+
+        static std::string to_string(const void* ptr)
+        {
+            return "shm:" + static_cast<const Impl*>(ptr)->options.name;
+        }
+
+    public:
+        explicit Impl(Options init_options)
+            : options(std::move(init_options))
+        {
+        }
+
+        ~Impl() override = default;
+
+        Impl(Impl&&) noexcept = delete;
+        Impl& operator=(Impl&&) noexcept = delete;
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+
+        void run() override
+        {
+            service_thread = std::this_thread::get_id();
+            auto _ = boost::asio::make_work_guard(ctx);
+            auto busy = clock::now();
+            const auto spin = std::chrono::microseconds(options.spin_us);
+            while (!ctx.stopped())
+            {
+                ctx.poll();
+                maintain();
+                if (receive() > 0)
+                {
+                    busy = clock::now();
+                }
+                else if (clock::now() - busy < spin)
+                {
+                    std::this_thread::yield();
+                }
+                else
+                {
+                    sleep();
+                    busy = clock::now();
+                }
+            }
+        }
+
+        void poll() override
+        {
+            service_thread = std::this_thread::get_id();
+            ctx.poll();
+            maintain();
+            receive();
+        }
+
+        void stop() override
+        {
+            stopping = true;
+            ctx.stop();
+            wake();
+            // releases the publishers waiting for room
+            if (auto target = current())
+            {
+                notify(target->output().shared().writable);
+            }
+        }
+
+        void restart() override
+        {
+            stopping = false;
+            ctx.restart();
+            connected = false;
+            ready_notified = false;
+            next_check = {};
+            std::lock_guard lock(m_mutex);
+            mapping.reset();
+        }
+
+        void dispatch(std::function<void()> task) override
+        {
+            boost::asio::post(ctx, std::move(task));
+            wake();
+        }
+
+        void publish(Payload data) override
+        {
+            write(data);
+        }
+
+        void publish_ex(std::vector<ID> ids, Payload data) override
+        {
+            if (std::find(ids.begin(), ids.end(), self_id()) == ids.end())
+            {
+                write(data);
+            }
+        }
+
+        void send(std::vector<ID> ids, Payload data) override
+        {
+            if (std::find(ids.begin(), ids.end(), self_id()) != ids.end())
+            {
+                write(data);
+            }
+        }
+
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
+    private:
+        Options options;
+        Pieces pieces;
+        boost::asio::io_context ctx;
+        std::atomic<std::thread::id> service_thread;
+
+        // guards `mapping`. publishers keep a reference while writing.
+        std::mutex m_mutex;
+        std::shared_ptr<Mapping> mapping;
+        // one publisher at a time (single producer ring)
+        std::mutex w_mutex;
+        // set by dispatch / stop to interrupt the sleep
+        std::atomic<bool> woken = false;
+        // set by stop until restart, publishers stop waiting for room
+        std::atomic<bool> stopping = false;
+
+        bool connected = false;
+        bool ready_notified = false;
+        clock::time_point next_check;
+
+        std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID)>> on_ready_cb;
+        std::vector<std::function<void(ID)>> on_connect_cb;
+        std::vector<std::function<void(ID)>> on_disconnect_cb;
+
+        [[nodiscard]] ID self_id() const
+        {
+            return ID{this, this, &to_string};
+        }
+
+        std::shared_ptr<Mapping> current()
+        {
+            std::lock_guard lock(m_mutex);
+            return mapping;
+        }
+
+        void replace(std::shared_ptr<Mapping> value)
+        {
+            std::lock_guard lock(m_mutex);
+            mapping = std::move(value);
+        }
+
+        void wake()
+        {
+            woken = true;
+            if (auto target = current())
+            {
+                notify(target->input().shared().readable);
+            }
+        }
+
+        void sleep()
+        {
+            if (!mapping)
+            {
+                ctx.run_for(CHECK_INTERVAL);
+                return;
+            }
+
+            auto& input = mapping->input();
+            wait(
+                input.shared().readable,
+                [&]() { return !input.empty() || woken.exchange(false); },
+                CHECK_INTERVAL
+            );
+        }
+
+        /**
+         * @brief attaches to the object and follows the state of the peer
+         */
+        void maintain()
+        {
+            const auto now = clock::now();
+            const auto check = now >= next_check;
+            if (check)
+            {
+                next_check = now + CHECK_INTERVAL;
+            }
+
+            if (!mapping)
+            {
+                if (check)
+                {
+                    attach();
+                }
+                return;
+            }
+
+            auto& peer = mapping->peer();
+            auto attached = peer.ready.load() != 0;
+            if (attached && check)
+            {
+                auto pid = peer.owner.load();
+                if (pid != 0 && !alive(pid))
+                {
+                    // frees the side for the next peer
+                    peer.ready.store(0);
+                    peer.owner.compare_exchange_strong(pid, 0);
+                    attached = false;
+                }
+            }
+
+            if (attached != connected)
+            {
+                connected = attached;
+                if (connected)
+                {
+                    utils::invoke(on_connect_cb, self_id());
+                }
+                else
+                {
+                    mapping->input().discard();
+                    utils::invoke(on_disconnect_cb, self_id());
+                }
+            }
+
+            // removed by a peer that left before this service attached
+            if (check && !connected && mapping->orphaned())
+            {
+                replace(nullptr);
+                attach();
+            }
+        }
+
+        void attach()
+        {
+            auto attached = Mapping::attach(options);
+            if (!attached)
+            {
+                return;
+            }
+
+            replace(std::move(attached));
+            if (!ready_notified)
+            {
+                ready_notified = true;
+                utils::invoke(on_ready_cb, self_id());
+            }
+        }
+
+        std::uint64_t receive()
+        {
+            if (!mapping)
+            {
+                return 0;
+            }
+
+            auto& input = mapping->input();
+            const auto count = input.read(
+                [this](const std::uint8_t* data, std::uint64_t size)
+                { utils::invoke(on_message_cb, self_id(), data, size); },
+                MAX_READS
+            );
+            if (count > 0)
+            {
+                notify(input.shared().writable);
+            }
+            return count;
+        }
+
+        void write(const Payload& msg)
+        {
+            if (msg.empty())
+            {
+                return;
+            }
+
+            // blocking the service thread would stop the reads the peer might be waiting for
+            const auto blocking = service_thread.load() != std::this_thread::get_id();
+            // nor waiting for the lock held by a thread that waits for room
+            std::unique_lock lock(w_mutex, std::defer_lock);
+            if (blocking)
+            {
+                lock.lock();
+            }
+            else if (!lock.try_lock())
+            {
+                return;
+            }
+            const auto target = current();
+            if (!target || msg.size() > target->max_payload())
+            {
+                return;
+            }
+
+            auto& output = target->output();
+            while (!stopping && target->peer().ready.load() != 0)
+            {
+                const auto head = output.shared().head.load();
+                if (output.write(msg.data(), msg.size()))
+                {
+                    notify(output.shared().readable);
+                    return;
+                }
+
+                if (!blocking || target != current())
+                {
+                    return;
+                }
+
+                wait(
+                    output.shared().writable,
+                    [&]() { return stopping || output.shared().head.load() != head; },
+                    CHECK_INTERVAL
+                );
+            }
+        }
+
+        void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
+        {
+            on_message_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_ready(std::function<void(ID)> handler) override
+        {
+            on_ready_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_connect(std::function<void(ID)> handler) override
+        {
+            on_connect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_disconnect(std::function<void(ID)> handler) override
+        {
+            on_disconnect_cb.push_back(std::move(handler));
+        }
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options)
+    {
+        return std::make_unique<Impl>(std::move(options));
+    }
+}
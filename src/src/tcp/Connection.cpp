@@ -2,116 +2,364 @@
 
 #include "../utils.hpp"
 
+#include <boost/asio/write.hpp>
+
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+#include <boost/asio/local/stream_protocol.hpp>
+#endif
+
+#include <algorithm>
+#include <utility>
+
 namespace nil::service::tcp
 {
-    Connection::Connection(
-        std::uint64_t buffer,
-        boost::asio::ip::tcp::socket init_socket,
-        ConnectedImpl<Connection>& init_impl
+    namespace
+    {
+        // upper bound of frames coalesced into one gather write
+        constexpr auto MAX_GATHER_FRAMES = 64u;
+    }
+
+    template <typename Protocol>
+    BasicConnection<Protocol>::BasicConnection(
+        FrameReader reader,
+        socket_type init_socket,
+        ConnectedImpl<BasicConnection>& init_impl,
+        Outbound& init_outbound
     )
         : socket(std::move(init_socket))
         , local_endpoint(socket.local_endpoint())
         , remote_endpoint(socket.remote_endpoint())
         , impl(init_impl)
+        , r_frames(std::move(reader))
+        , r_idle(socket.get_executor())
+        , outbound(init_outbound)
+        , alive(std::make_shared<bool>(true))
     {
-        r_buffer.resize(buffer + utils::TCP_HEADER_SIZE);
+        if constexpr (RECORDS)
+        {
+            r_record = ReceiveBuffer(r_frames.max_size() + 1);
+        }
     }
 
-    Connection::~Connection() noexcept = default;
+    template <typename Protocol>
+    BasicConnection<Protocol>::~BasicConnection() noexcept
+    {
+        *alive = false;
+        outbound.remove(w_bytes);
+        if (stalled)
+        {
+            outbound.stall(false);
+        }
+    }
 
-    void Connection::run()
+    template <typename Protocol>
+    void BasicConnection<Protocol>::run()
     {
-        readHeader(utils::START_INDEX, utils::TCP_HEADER_SIZE);
+        read();
         impl.connect(this);
     }
 
-    void Connection::readHeader(std::uint64_t pos, std::uint64_t size)
+    template <typename Protocol>
+    void BasicConnection<Protocol>::read()
     {
-        socket.async_read_some(
-            boost::asio::buffer(r_buffer.data() + pos, size - pos),
-            [pos, size, this](
-                const boost::system::error_code& ec,
-                std::size_t count //
-            )
+        if constexpr (RECORDS)
+        {
+            if (r_record.lent())
             {
-                if (ec)
+                // a handler kept the previous record
+                r_record.relocate(r_record.size(), 0, 0);
+            }
+            socket.async_receive(
+                boost::asio::buffer(r_record.data(), r_record.size()),
+                r_flags,
+                [this](const boost::system::error_code& ec, std::size_t count)
                 {
-                    impl.disconnect(this);
-                    return;
+                    // messages are never empty, an empty record is the end of the stream
+                    if (ec || count == 0 || count > r_frames.max_size())
+                    {
+                        impl.disconnect(this);
+                        return;
+                    }
+
+                    {
+                        const auto lend = r_record.lend();
+                        impl.message(remote_id(), r_record.data(), count);
+                    }
+                    read();
+                }
+            );
+        }
+        else
+        {
+            socket.async_read_some(
+                r_frames.prepare(),
+                [this](const boost::system::error_code& ec, std::size_t count)
+                {
+                    if (ec)
+                    {
+                        impl.disconnect(this);
+                        return;
+                    }
+
+                    r_frames.commit(count);
+                    const auto valid = r_frames.consume(
+                        [this](const std::uint8_t* data, std::uint64_t size)
+                        {
+                            if (size > 0)
+                            {
+                                impl.message(remote_id(), data, size);
+                            }
+                        }
+                    );
+
+                    if (!valid)
+                    {
+                        impl.disconnect(this);
+                        return;
+                    }
+
+                    read();
+                    watch_idle();
                 }
+            );
+        }
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::watch_idle()
+    {
+        if (r_idle_armed || !r_frames.grown())
+        {
+            return;
+        }
 
-                if (pos + count != size)
+        r_idle_armed = true;
+        r_idle.expires_after(r_frames.idle());
+        r_idle.async_wait(
+            [this](const boost::system::error_code& ec)
+            {
+                if (ec)
                 {
-                    readHeader(pos + count, size);
                     return;
                 }
 
-                readBody(utils::START_INDEX, utils::from_array<std::uint64_t>(r_buffer.data()));
+                r_idle_armed = false;
+                r_frames.release_idle();
+                watch_idle();
             }
         );
     }
 
-    void Connection::readBody(std::uint64_t pos, std::uint64_t size)
+    template <typename Protocol>
+    void BasicConnection<Protocol>::write(Payload payload)
     {
-        if (size == 0)
+        // empty messages are not delivered by the receiving side
+        if (!socket.is_open() || (RECORDS && payload.empty()))
         {
-            readHeader(utils::START_INDEX, utils::TCP_HEADER_SIZE);
             return;
         }
 
-        if (size > r_buffer.size() - utils::TCP_HEADER_SIZE)
+        const auto frame_size = payload.size() + HEADER_SIZE;
+        if (exceeds(frame_size))
         {
-            impl.disconnect(this);
-            return;
+            raise_backpressure();
+            switch (outbound.limits().policy)
+            {
+                case Backpressure::Policy::drop_newest:
+                    return;
+                case Backpressure::Policy::drop_oldest:
+                    drop_oldest(frame_size);
+                    break;
+                case Backpressure::Policy::disconnect:
+                    close();
+                    return;
+                case Backpressure::Policy::block:
+                    // callers are held back by Outbound until the backlog drains
+                    break;
+            }
+        }
+
+        w_queue.push_back({utils::to_array(payload.size()), std::move(payload)});
+        account_added(frame_size);
+        if (w_flight.empty())
+        {
+            flush();
+        }
+    }
+
+    template <typename Protocol>
+    bool BasicConnection<Protocol>::exceeds(std::uint64_t size) const
+    {
+        return exceeds_own(size) || outbound.exceeds(size);
+    }
+
+    template <typename Protocol>
+    bool BasicConnection<Protocol>::exceeds_own(std::uint64_t size) const
+    {
+        const auto& limits = outbound.limits();
+        const auto messages = w_queue.size() + w_flight.size();
+        return (limits.max_bytes != 0 && w_bytes + size > limits.max_bytes)
+            || (limits.max_messages != 0 && messages >= limits.max_messages);
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::drop_oldest(std::uint64_t size)
+    {
+        while (!w_queue.empty() && exceeds(size))
+        {
+            account_removed(w_queue.front().body.size() + HEADER_SIZE);
+            w_queue.pop_front();
+        }
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::account_added(std::uint64_t size)
+    {
+        w_bytes += size;
+        outbound.add(size);
+
+        const auto& limits = outbound.limits();
+        if (!stalled && limits.policy == Backpressure::Policy::block && exceeds_own(0))
+        {
+            stalled = true;
+            outbound.stall(true);
+        }
+
+        if (high_water() != 0 && w_bytes >= high_water())
+        {
+            raise_backpressure();
+        }
+    }
+
+    template <typename Protocol>
+    std::uint64_t BasicConnection<Protocol>::high_water() const
+    {
+        const auto& limits = outbound.limits();
+        return limits.high_water != 0 ? limits.high_water : limits.max_bytes;
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::raise_backpressure()
+    {
+        if (!congested)
+        {
+            congested = true;
+            impl.backpressure(this);
+        }
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::account_removed(std::uint64_t size)
+    {
+        w_bytes -= size;
+        outbound.remove(size);
+
+        if (stalled && !exceeds_own(0))
+        {
+            stalled = false;
+            outbound.stall(false);
+        }
+
+        if (congested && w_bytes <= high_water() / 2)
+        {
+            congested = false;
+            impl.drain(this);
+        }
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::close()
+    {
+        // reader will observe the closed socket and report the disconnect
+        congested = false;
+        account_removed(w_bytes - w_flight_bytes);
+        w_queue.clear();
+        boost::system::error_code ignored;
+        socket.close(ignored);
+    }
+
+    template <typename Protocol>
+    void BasicConnection<Protocol>::flush()
+    {
+        // a record is sent per message, frames are coalesced into one gather write
+        const auto count
+            = RECORDS ? 1 : std::min<std::size_t>(w_queue.size(), MAX_GATHER_FRAMES);
+        for (auto i = 0u; i < count; ++i)
+        {
+            w_flight_bytes += w_queue.front().body.size() + HEADER_SIZE;
+            w_flight.push_back(std::move(w_queue.front()));
+            w_queue.pop_front();
         }
 
-        socket.async_read_some(
-            boost::asio::buffer(r_buffer.data() + pos, size - pos),
-            [pos, size, this](const boost::system::error_code& ec, std::size_t count)
+        auto on_written = [this, alive = alive](const boost::system::error_code& ec, std::size_t)
+        {
+            if (!*alive)
             {
-                if (ec)
-                {
-                    impl.disconnect(this);
-                    return;
-                }
+                return;
+            }
 
-                if (pos + count != size)
-                {
-                    readBody(pos + count, size);
-                }
-                else
+            w_flight.clear();
+            account_removed(std::exchange(w_flight_bytes, 0));
+            if (ec)
+            {
+                close();
+                return;
+            }
+
+            if (!w_queue.empty())
+            {
+                flush();
+            }
+        };
+
+        if constexpr (RECORDS)
+        {
+            const auto& body = w_flight.front().body;
+            socket.async_send(
+                boost::asio::buffer(body.data(), body.size()),
+                0,
+                std::move(on_written)
+            );
+        }
+        else
+        {
+            w_buffers.clear();
+            for (const auto& frame : w_flight)
+            {
+                w_buffers.emplace_back(boost::asio::buffer(frame.header));
+                if (!frame.body.empty())
                 {
-                    impl.message(remote_id(), r_buffer.data(), size);
-                    readHeader(utils::START_INDEX, utils::TCP_HEADER_SIZE);
+                    const auto& body = frame.body;
+                    w_buffers.emplace_back(boost::asio::buffer(body.data(), body.size()));
                 }
             }
-        );
-    }
-
-    void Connection::write(const std::uint8_t* data, std::uint64_t size)
-    {
-        boost::system::error_code ec;
-        socket.write_some(
-            std::array<boost::asio::const_buffer, 2>{
-                boost::asio::buffer(utils::to_array(size)),
-                boost::asio::buffer(data, size)
-            },
-            ec
-        );
+            boost::asio::async_write(socket, w_buffers, std::move(on_written));
+        }
     }
 
-    std::string Connection::to_string_local(const void* c)
+    template <typename Protocol>
+    std::string BasicConnection<Protocol>::to_string_local(const void* c)
     {
-        return utils::to_id(static_cast<const Connection*>(c)->local_endpoint);
+        return utils::to_id(static_cast<const BasicConnection*>(c)->local_endpoint);
     }
 
-    std::string Connection::to_string_remote(const void* c)
+    template <typename Protocol>
+    std::string BasicConnection<Protocol>::to_string_remote(const void* c)
     {
-        return utils::to_id(static_cast<const Connection*>(c)->remote_endpoint);
+        return utils::to_id(static_cast<const BasicConnection*>(c)->remote_endpoint);
     }
 
-    ID Connection::remote_id() const
+    template <typename Protocol>
+    ID BasicConnection<Protocol>::remote_id() const
     {
         return ID{&impl, this, &to_string_remote};
     }
+
+    template class BasicConnection<boost::asio::ip::tcp>;
+    template class BasicConnection<boost::asio::generic::seq_packet_protocol>;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    template class BasicConnection<boost::asio::local::stream_protocol>;
+#endif
 }
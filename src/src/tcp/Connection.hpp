@@ -1,45 +1,113 @@
 #pragma once
 
 #include "../ConnectedImpl.hpp"
+#include "../FrameReader.hpp"
+#include "../Outbound.hpp"
+#include "../ReceiveBuffer.hpp"
+#include "../utils.hpp"
 
 #include <nil/service/ID.hpp>
+#include <nil/service/payload.hpp>
 
+#include <boost/asio/basic_seq_packet_socket.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <array>
+#include <deque>
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace nil::service::tcp
 {
-    class Connection final
+    /**
+     * @brief connection of a stream oriented protocol (tcp, unix stream sockets)
+     *  using the length-prefixed framing, or of a record oriented one
+     *  (unix seqpacket sockets) where each record is a message and no header is needed.
+     */
+    template <typename Protocol>
+    class BasicConnection final
     {
     public:
-        Connection(
-            std::uint64_t buffer,
-            boost::asio::ip::tcp::socket socket,
-            ConnectedImpl<Connection>& impl
+        using socket_type = typename Protocol::socket;
+        using endpoint_type = typename Protocol::endpoint;
+
+        BasicConnection(
+            FrameReader reader,
+            socket_type socket,
+            ConnectedImpl<BasicConnection>& impl,
+            Outbound& outbound
         );
-        ~Connection() noexcept;
+        ~BasicConnection() noexcept;
 
-        Connection(Connection&&) noexcept = delete;
-        Connection(const Connection&) = delete;
-        Connection& operator=(Connection&&) noexcept = delete;
-        Connection& operator=(const Connection&) = delete;
+        BasicConnection(BasicConnection&&) noexcept = delete;
+        BasicConnection(const BasicConnection&) = delete;
+        BasicConnection& operator=(BasicConnection&&) noexcept = delete;
+        BasicConnection& operator=(const BasicConnection&) = delete;
 
         void run();
-        void write(const std::uint8_t* data, std::uint64_t size);
+        /**
+         * @brief queue a frame for writing. non-blocking.
+         *  queued frames are coalesced into a single gather write.
+         */
+        void write(Payload payload);
         ID remote_id() const;
 
         static std::string to_string_local(const void* c);
         static std::string to_string_remote(const void* c);
 
     private:
-        void readHeader(std::uint64_t pos, std::uint64_t size);
-        void readBody(std::uint64_t pos, std::uint64_t size);
-
-        boost::asio::ip::tcp::socket socket;
-        boost::asio::ip::tcp::endpoint local_endpoint;
-        boost::asio::ip::tcp::endpoint remote_endpoint;
-        ConnectedImpl<Connection>& impl;
-        std::vector<std::uint8_t> r_buffer;
+        // messages are delimited by the socket, one record per message
+        static constexpr bool RECORDS = std::is_same_v<
+            socket_type,
+            boost::asio::basic_seq_packet_socket<Protocol>>;
+        static constexpr std::uint64_t HEADER_SIZE = RECORDS ? 0 : utils::TCP_HEADER_SIZE;
+
+        void read();
+        void watch_idle();
+        void flush();
+        void close();
+        [[nodiscard]] bool exceeds(std::uint64_t size) const;
+        [[nodiscard]] bool exceeds_own(std::uint64_t size) const;
+        void drop_oldest(std::uint64_t size);
+        void account_added(std::uint64_t size);
+        void account_removed(std::uint64_t size);
+        [[nodiscard]] std::uint64_t high_water() const;
+        void raise_backpressure();
+
+        struct Frame final
+        {
+            std::array<std::uint8_t, sizeof(std::uint64_t)> header;
+            Payload body;
+        };
+
+        socket_type socket;
+        endpoint_type local_endpoint;
+        endpoint_type remote_endpoint;
+        ConnectedImpl<BasicConnection>& impl;
+        FrameReader r_frames;
+        // a record larger than the maximum payload size fills it completely
+        ReceiveBuffer r_record;
+        boost::asio::socket_base::message_flags r_flags = 0;
+        // releases the grown receive buffer of idle connections
+        boost::asio::steady_timer r_idle;
+        bool r_idle_armed = false;
+
+        Outbound& outbound;
+        // frames waiting to be written
+        std::deque<Frame> w_queue;
+        // frames of the in-flight gather write
+        std::vector<Frame> w_flight;
+        std::vector<boost::asio::const_buffer> w_buffers;
+        // bytes of both waiting and in-flight frames
+        std::uint64_t w_bytes = 0;
+        std::uint64_t w_flight_bytes = 0;
+        bool congested = false;
+        bool stalled = false;
+        // pending write handlers may outlive the connection.
+        std::shared_ptr<bool> alive;
     };
+
+    using Connection = BasicConnection<boost::asio::ip::tcp>;
 }
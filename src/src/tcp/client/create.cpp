@@ -1,5 +1,6 @@
 #include <nil/service/tcp/client/create.hpp>
 
+#include "../../Pieces.hpp"
 #include "../../utils.hpp"
 #include "../Connection.hpp"
 
@@ -10,6 +11,7 @@
 #include <boost/asio/strand.hpp>
 
 #include <algorithm>
+#include <chrono>
 
 namespace nil::service::tcp::client
 {
@@ -33,6 +35,7 @@ namespace nil::service::tcp::client
     public:
         explicit Impl(Options init_options)
             : options(std::move(init_options))
+            , outbound(options.backpressure)
             , context(std::make_unique<Context>())
         {
             connect();
@@ -58,11 +61,13 @@ namespace nil::service::tcp::client
 
         void stop() override
         {
+            outbound.release(true);
             context->ctx.stop();
         }
 
         void restart() override
         {
+            outbound.release(false);
             context = std::make_unique<Context>();
             connect();
         }
@@ -72,19 +77,32 @@ namespace nil::service::tcp::client
             boost::asio::post(context->ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, msg = std::move(data)]() { write_if_connected(msg); }
+                [this, ticket = std::move(*ticket), msg = std::move(data)]()
+                { write_if_connected(msg); }
             );
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
                 {
                     if (!has_remote_id(ids))
                     {
@@ -94,11 +112,17 @@ namespace nil::service::tcp::client
             );
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
                 {
                     if (has_remote_id(ids))
                     {
@@ -108,8 +132,20 @@ namespace nil::service::tcp::client
             );
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
     private:
         Options options;
+        Pieces pieces;
+        Outbound outbound;
         std::unique_ptr<Context> context;
         std::unique_ptr<Connection> connection;
 
@@ -117,6 +153,13 @@ namespace nil::service::tcp::client
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
+
+        [[nodiscard]] bool in_service_thread() const
+        {
+            return context->ctx.get_executor().running_in_this_thread();
+        }
 
         [[nodiscard]] bool has_remote_id(const std::vector<ID>& ids) const
         {
@@ -127,11 +170,11 @@ namespace nil::service::tcp::client
             return ids.end() != std::find(ids.begin(), ids.end(), connection->remote_id());
         }
 
-        void write_if_connected(const std::vector<std::uint8_t>& msg)
+        void write_if_connected(const Payload& msg)
         {
             if (connection != nullptr)
             {
-                connection->write(msg.data(), msg.size());
+                connection->write(msg);
             }
         }
 
@@ -156,6 +199,16 @@ namespace nil::service::tcp::client
             );
         }
 
+        void backpressure(Connection* target_connection) override
+        {
+            utils::invoke(on_backpressure_cb, target_connection->remote_id());
+        }
+
+        void drain(Connection* target_connection) override
+        {
+            utils::invoke(on_drain_cb, target_connection->remote_id());
+        }
+
         void message(ID id, const void* data, std::uint64_t size) override
         {
             utils::invoke(on_message_cb, id, data, size);
@@ -173,9 +226,14 @@ namespace nil::service::tcp::client
                     if (!ec)
                     {
                         connection = std::make_unique<Connection>(
-                            options.buffer,
+                            FrameReader(
+                                options.buffer_initial,
+                                options.buffer,
+                                std::chrono::milliseconds(options.buffer_idle_ms)
+                            ),
                             std::move(*socket),
-                            *this
+                            *this,
+                            outbound
                         );
                         utils::invoke(
                             on_ready_cb,
@@ -222,6 +280,16 @@ namespace nil::service::tcp::client
         {
             on_disconnect_cb.push_back(std::move(handler));
         }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
     };
 
     std::unique_ptr<IStandaloneService> create(Options options)
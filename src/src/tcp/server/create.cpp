@@ -1,5 +1,7 @@
 #include <nil/service/tcp/server/create.hpp>
 
+#include "../../Pieces.hpp"
+#include "../../Registry.hpp"
 #include "../../utils.hpp"
 #include "../Connection.hpp"
 
@@ -9,42 +11,117 @@
 #include <boost/asio/strand.hpp>
 
 #include <algorithm>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace nil::service::tcp::server
 {
-    struct Context
+    struct Impl;
+
+    /**
+     * @brief an io_context with the connections it serves.
+     *  each shard is run by its own thread.
+     */
+    struct Shard final: ConnectedImpl<Connection>
     {
-        explicit Context(const std::string& host, std::uint16_t port)
-            : strand(make_strand(ctx))
-            , acceptor(strand, {boost::asio::ip::make_address(host), port}, true)
+        explicit Shard(Impl& init_parent)
+            : parent(init_parent)
+            , strand(make_strand(ctx))
         {
-            acceptor.set_option(boost::asio::socket_base::reuse_address(true));
         }
 
+        ~Shard() noexcept override = default;
+
+        Shard(Shard&&) noexcept = delete;
+        Shard& operator=(Shard&&) noexcept = delete;
+        Shard(const Shard&) = delete;
+        Shard& operator=(const Shard&) = delete;
+
+        void connect(Connection* connection) override;
+        void disconnect(Connection* connection) override;
+        void backpressure(Connection* connection) override;
+        void drain(Connection* connection) override;
+        void message(ID id, const void* data, std::uint64_t size) override;
+
+        Impl& parent;
         boost::asio::io_context ctx;
         boost::asio::strand<boost::asio::io_context::executor_type> strand;
-        boost::asio::ip::tcp::acceptor acceptor;
+        std::optional<boost::asio::ip::tcp::acceptor> acceptor;
+        // declared after ctx so that the sockets are closed before it is destroyed
+        Registry<Connection> connections;
+    };
+
+    struct Context
+    {
+        explicit Context(Impl& parent, const Options& options)
+            : shards(make_shards(parent, options.threads))
+            , sharded_accept(options.reuse_port && utils::HAS_REUSE_PORT && shards.size() > 1)
+        {
+            auto endpoint = boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::make_address(options.host),
+                options.port
+            );
+            for (const auto& shard : shards)
+            {
+                auto& acceptor = shard->acceptor.emplace(shard->strand);
+                utils::bind(acceptor, endpoint, sharded_accept);
+                acceptor.listen();
+                if (!sharded_accept)
+                {
+                    break;
+                }
+                // the rest binds to the same port even if an ephemeral one was requested
+                endpoint = acceptor.local_endpoint();
+            }
+        }
+
+        std::vector<std::unique_ptr<Shard>> shards;
+        // true:  every shard accepts its own connections
+        // false: shards.front() accepts and distributes the connections
+        bool sharded_accept;
+        std::size_t next_shard = 0;
+
+        Shard& main()
+        {
+            return *shards.front();
+        }
+
+        static std::vector<std::unique_ptr<Shard>> make_shards(Impl& parent, std::uint32_t count)
+        {
+            std::vector<std::unique_ptr<Shard>> shards;
+            shards.reserve(std::max(count, 1u));
+            do
+            {
+                shards.push_back(std::make_unique<Shard>(parent));
+            } while (shards.size() < count);
+            return shards;
+        }
     };
 
-    struct Impl final
-        : IStandaloneService
-        , ConnectedImpl<Connection>
+    struct Impl final: IStandaloneService
     {
+        friend struct Shard;
+
         static std::string to_string_local(const void* c)
         {
-            return utils::to_id(static_cast<const Impl*>(c)->context->acceptor.local_endpoint());
+            const auto& acceptor = static_cast<const Impl*>(c)->context->main().acceptor;
+            return utils::to_id(acceptor->local_endpoint());
         }
 
     public:
         explicit Impl(Options init_options)
             : options(std::move(init_options))
-            , context(std::make_unique<Context>(options.host, options.port))
+            , outbound(options.backpressure)
+            , context(std::make_unique<Context>(*this, options))
         {
             boost::asio::post(
-                context->ctx,
+                context->main().ctx,
                 [this]() { utils::invoke(on_ready_cb, ID{this, this, Impl::to_string_local}); }
             );
-            accept();
+            accept_all();
         }
 
         ~Impl() override = default;
@@ -56,162 +133,272 @@ namespace nil::service::tcp::server
 
         void run() override
         {
-            auto _ = boost::asio::make_work_guard(context->ctx);
-            context->ctx.run();
+            const auto& shards = context->shards;
+            std::vector<std::thread> threads;
+            threads.reserve(shards.size() - 1);
+            for (auto it = std::next(shards.begin()); it != shards.end(); ++it)
+            {
+                threads.emplace_back([shard = it->get()]() { run_shard(*shard); });
+            }
+            run_shard(*shards.front());
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
         }
 
         void poll() override
         {
-            context->ctx.poll();
+            for (const auto& shard : context->shards)
+            {
+                shard->ctx.poll();
+            }
         }
 
         void stop() override
         {
-            context->ctx.stop();
+            outbound.release(true);
+            for (const auto& shard : context->shards)
+            {
+                shard->ctx.stop();
+            }
         }
 
         void restart() override
         {
-            context = std::make_unique<Context>(options.host, options.port);
+            outbound.release(false);
+            context.reset();
+            context = std::make_unique<Context>(*this, options);
             boost::asio::post(
-                context->ctx,
+                context->main().ctx,
                 [this]() { utils::invoke(on_ready_cb, ID{this, this, Impl::to_string_local}); }
             );
-            accept();
+            accept_all();
         }
 
         void dispatch(std::function<void()> task) override
         {
-            boost::asio::dispatch(context->ctx, std::move(task));
+            boost::asio::dispatch(context->main().ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, msg = std::move(data)]()
-                {
-                    for (const auto& connection : connections)
+            auto ticket = admit(data);
+            if (!ticket)
+            {
+                return;
+            }
+
+            for (const auto& shard : context->shards)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard.get(), ticket, msg = data]()
                     {
-                        write_payload(*connection, msg);
+                        for (const auto& connection : shard->connections)
+                        {
+                            write_payload(*connection, msg);
+                        }
                     }
-                }
-            );
+                );
+            }
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+            auto ticket = admit(data);
+            if (!ticket)
+            {
+                return;
+            }
+
+            auto excluded = std::make_shared<std::unordered_set<const void*>>();
+            for (const auto& id : ids)
+            {
+                if (find_shard(id) != nullptr)
                 {
-                    for (const auto& connection : connections)
+                    excluded->emplace(id.id);
+                }
+            }
+
+            for (const auto& shard : context->shards)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard.get(), ticket, excluded, msg = data]()
                     {
-                        if (contains_id(ids, connection->remote_id()))
+                        for (const auto& connection : shard->connections)
                         {
-                            continue;
-                        }
+                            if (excluded->contains(connection.get()))
+                            {
+                                continue;
+                            }
 
-                        write_payload(*connection, msg);
+                            write_payload(*connection, msg);
+                        }
                     }
-                }
-            );
+                );
+            }
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+            auto ticket = admit(data);
+            if (!ticket)
+            {
+                return;
+            }
+
+            // IDs are owned by the shard of the connection so only that shard is involved
+            std::unordered_map<Shard*, std::vector<const void*>> targets;
+            for (const auto& id : ids)
+            {
+                if (auto* shard = find_shard(id); shard != nullptr)
                 {
-                    for (const auto& id : ids)
+                    targets[shard].push_back(id.id);
+                }
+            }
+
+            for (auto& [shard, keys] : targets)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard, ticket, keys = std::move(keys), msg = data]()
                     {
-                        auto it = find_connection(id);
-                        if (it != connections.end())
+                        for (const auto* key : keys)
                         {
-                            write_payload(**it, msg);
+                            if (auto* connection = shard->connections.find(key))
+                            {
+                                write_payload(*connection, msg);
+                            }
                         }
                     }
-                }
-            );
+                );
+            }
+        }
+
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
         }
 
     private:
         Options options;
+        Pieces pieces;
+        Outbound outbound;
         std::unique_ptr<Context> context;
-        std::vector<std::unique_ptr<Connection>> connections;
 
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
 
-        static void write_payload(Connection& connection, const std::vector<std::uint8_t>& msg)
+        static void run_shard(Shard& shard)
         {
-            connection.write(msg.data(), msg.size());
+            auto _ = boost::asio::make_work_guard(shard.ctx);
+            shard.ctx.run();
         }
 
-        [[nodiscard]] static bool contains_id(const std::vector<ID>& ids, const ID& target)
+        [[nodiscard]] bool in_service_thread() const
         {
-            return ids.end() != std::find(ids.begin(), ids.end(), target);
+            return std::any_of(
+                context->shards.begin(),
+                context->shards.end(),
+                [](const auto& shard) { return shard->ctx.get_executor().running_in_this_thread(); }
+            );
         }
 
-        [[nodiscard]] auto find_connection(const ID& id
-        ) -> std::vector<std::unique_ptr<Connection>>::iterator
+        /**
+         * @brief the ticket is shared by the fan-out to all shards and
+         *  is released once every shard has queued the payload.
+         */
+        [[nodiscard]] std::shared_ptr<Outbound::Ticket> admit(const Payload& data)
         {
-            return std::find_if(
-                connections.begin(),
-                connections.end(),
-                [&id](const auto& connection) { return id == connection->remote_id(); }
-            );
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return nullptr;
+            }
+            return std::make_shared<Outbound::Ticket>(std::move(*ticket));
         }
 
-        void connect(Connection* connection) override
+        static void write_payload(Connection& connection, const Payload& msg)
         {
-            utils::invoke(on_connect_cb, connection->remote_id());
+            connection.write(msg);
         }
 
-        void disconnect(Connection* connection) override
+        [[nodiscard]] Shard* find_shard(const ID& id) const
         {
-            boost::asio::post(
-                context->strand,
-                [this, id = connection->remote_id()]()
+            for (const auto& shard : context->shards)
+            {
+                // connections identify their owner through the ConnectedImpl base
+                if (static_cast<const ConnectedImpl<Connection>*>(shard.get()) == id.owner)
                 {
-                    utils::invoke(on_disconnect_cb, id);
-                    connections.erase(
-                        std::remove_if(
-                            connections.begin(),
-                            connections.end(),
-                            [&id](const auto& current) { return current->remote_id() == id; }
-                        ),
-                        connections.end()
-                    );
+                    return shard.get();
                 }
-            );
+            }
+            return nullptr;
         }
 
-        void message(ID id, const void* data, std::uint64_t size) override
+        Shard& next_shard()
         {
-            utils::invoke(on_message_cb, id, data, size);
+            auto& shards = context->shards;
+            auto& shard = *shards[context->next_shard];
+            context->next_shard = (context->next_shard + 1) % shards.size();
+            return shard;
         }
 
-        void accept()
+        void accept_all()
         {
-            context->acceptor.async_accept(
-                context->ctx,
-                [this](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket)
+            for (const auto& shard : context->shards)
+            {
+                if (shard->acceptor)
+                {
+                    accept(*shard);
+                }
+            }
+        }
+
+        void accept(Shard& listener)
+        {
+            auto& shard = context->sharded_accept ? listener : next_shard();
+            listener.acceptor->async_accept(
+                shard.ctx,
+                [this, &listener, &shard](
+                    const boost::system::error_code& ec,
+                    boost::asio::ip::tcp::socket socket
+                )
                 {
                     if (!ec)
                     {
-                        auto connection = std::make_unique<Connection>(
-                            options.buffer,
-                            std::move(socket),
-                            *this
+                        // the connection is owned and started by the shard's thread
+                        boost::asio::post(
+                            shard.strand,
+                            [this, &shard, socket = std::move(socket)]() mutable
+                            {
+                                auto connection = std::make_unique<Connection>(
+                                    FrameReader(
+                                        options.buffer_initial,
+                                        options.buffer,
+                                        std::chrono::milliseconds(options.buffer_idle_ms)
+                                    ),
+                                    std::move(socket),
+                                    shard,
+                                    outbound
+                                );
+                                connection->run();
+                                shard.connections.add(std::move(connection));
+                            }
                         );
-                        connection->run();
-                        connections.push_back(std::move(connection));
                     }
-                    accept();
+                    accept(listener);
                 }
             );
         }
@@ -235,8 +422,50 @@ namespace nil::service::tcp::server
         {
             on_disconnect_cb.push_back(std::move(handler));
         }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
     };
 
+    void Shard::connect(Connection* connection)
+    {
+        utils::invoke(parent.on_connect_cb, connection->remote_id());
+    }
+
+    void Shard::disconnect(Connection* connection)
+    {
+        boost::asio::post(
+            strand,
+            [this, id = connection->remote_id()]()
+            {
+                utils::invoke(parent.on_disconnect_cb, id);
+                connections.remove(id.id);
+            }
+        );
+    }
+
+    void Shard::backpressure(Connection* connection)
+    {
+        utils::invoke(parent.on_backpressure_cb, connection->remote_id());
+    }
+
+    void Shard::drain(Connection* connection)
+    {
+        utils::invoke(parent.on_drain_cb, connection->remote_id());
+    }
+
+    void Shard::message(ID id, const void* data, std::uint64_t size)
+    {
+        utils::invoke(parent.on_message_cb, id, data, size);
+    }
+
     std::unique_ptr<IStandaloneService> create(Options options)
     {
         return std::make_unique<Impl>(std::move(options));
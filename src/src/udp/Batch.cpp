@@ -0,0 +1,285 @@
+#include "Batch.hpp"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#include <netinet/in.h>
+
+#include <cerrno>
+#include <cstring>
+
+// not exposed by older libc headers (linux 4.18 / 5.0)
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
+namespace nil::service::udp
+{
+#if defined(__linux__)
+    namespace
+    {
+        // a coalesced datagram never exceeds the size of an ip packet
+        constexpr std::uint64_t MAX_COALESCED = 65535;
+        // largest udp payload over ipv4
+        constexpr std::uint64_t MAX_SEGMENTED = 65507;
+        // UDP_MAX_SEGMENTS of the kernel
+        constexpr std::size_t MAX_SEGMENTS = 64;
+        constexpr auto CONTROL_SIZE = CMSG_SPACE(sizeof(int));
+    }
+
+    Batch::Batch(std::uint32_t init_capacity, std::uint64_t init_buffer, bool init_offload)
+        : capacity(std::max(init_capacity, 1u))
+        , buffer(init_offload ? std::max(init_buffer, MAX_COALESCED) : init_buffer)
+        , offload(init_offload)
+        , gso(init_offload)
+        , r_data(capacity * buffer)
+        , r_endpoints(capacity)
+        , r_headers(capacity)
+        , r_iovecs(capacity)
+        , r_controls(capacity * CONTROL_SIZE)
+        , w_headers(capacity)
+        , w_iovecs(2 * std::max<std::size_t>(capacity, MAX_SEGMENTS))
+    {
+    }
+
+    bool Batch::coalesce(boost::asio::ip::udp::socket& socket)
+    {
+        const int enable = 1;
+        gro = offload
+            && ::setsockopt(socket.native_handle(), IPPROTO_UDP, UDP_GRO, &enable, sizeof(enable))
+                == 0;
+        return gro;
+    }
+
+    std::size_t Batch::receive(boost::asio::ip::udp::socket& socket)
+    {
+        for (auto i = 0u; i < capacity; ++i)
+        {
+            r_iovecs[i] = {r_data.data() + i * buffer, buffer};
+            r_headers[i] = {};
+            r_headers[i].msg_hdr.msg_name = r_endpoints[i].data();
+            r_headers[i].msg_hdr.msg_namelen = socklen_t(r_endpoints[i].capacity());
+            r_headers[i].msg_hdr.msg_iov = &r_iovecs[i];
+            r_headers[i].msg_hdr.msg_iovlen = 1;
+            if (gro)
+            {
+                r_headers[i].msg_hdr.msg_control = r_controls.data() + i * CONTROL_SIZE;
+                r_headers[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+            }
+        }
+
+        r_views.clear();
+        const auto count = ::recvmmsg(
+            socket.native_handle(),
+            r_headers.data(),
+            capacity,
+            MSG_DONTWAIT,
+            nullptr
+        );
+        if (count <= 0)
+        {
+            return 0;
+        }
+
+        for (auto i = 0; i < count; ++i)
+        {
+            auto& header = r_headers[i].msg_hdr;
+            r_endpoints[i].resize(header.msg_namelen);
+            const std::uint64_t size = r_headers[i].msg_len;
+
+            // coalesced datagrams are all of the segment size but the last
+            std::uint64_t segment = 0;
+            auto* c = gro ? CMSG_FIRSTHDR(&header) : nullptr;
+            for (; c != nullptr; c = CMSG_NXTHDR(&header, c))
+            {
+                if (c->cmsg_level == IPPROTO_UDP && c->cmsg_type == UDP_GRO)
+                {
+                    int value = 0;
+                    std::memcpy(&value, CMSG_DATA(c), sizeof(value));
+                    segment = std::uint64_t(std::max(value, 0));
+                }
+            }
+
+            if (segment == 0 || size <= segment)
+            {
+                r_views.push_back({std::size_t(i), 0, size});
+                continue;
+            }
+
+            for (std::uint64_t offset = 0; offset < size; offset += segment)
+            {
+                r_views.push_back({std::size_t(i), offset, std::min(segment, size - offset)});
+            }
+        }
+        return r_views.size();
+    }
+
+    std::size_t Batch::send(
+        boost::asio::ip::udp::socket& socket,
+        boost::asio::const_buffer header,
+        boost::asio::const_buffer body,
+        const std::vector<const boost::asio::ip::udp::endpoint*>& endpoints
+    )
+    {
+        std::size_t sent = 0;
+        while (sent < endpoints.size())
+        {
+            const auto count = std::min<std::size_t>(capacity, endpoints.size() - sent);
+            for (auto i = 0u; i < count; ++i)
+            {
+                // the body is shared, only the destination differs
+                auto* iov = &w_iovecs[2 * i];
+                iov[0] = {const_cast<void*>(header.data()), header.size()};
+                iov[1] = {const_cast<void*>(body.data()), body.size()};
+                const auto& endpoint = *endpoints[sent + i];
+                w_headers[i] = {};
+                w_headers[i].msg_hdr.msg_name = const_cast<void*>(
+                    static_cast<const void*>(endpoint.data())
+                );
+                w_headers[i].msg_hdr.msg_namelen = socklen_t(endpoint.size());
+                w_headers[i].msg_hdr.msg_iov = iov;
+                w_headers[i].msg_hdr.msg_iovlen = 2;
+            }
+
+            const auto result = ::sendmmsg(
+                socket.native_handle(),
+                w_headers.data(),
+                unsigned(count),
+                MSG_DONTWAIT
+            );
+            if (result <= 0)
+            {
+                break;
+            }
+
+            sent += std::size_t(result);
+            if (std::size_t(result) != count)
+            {
+                break;
+            }
+        }
+        return sent;
+    }
+
+    std::size_t Batch::send_segments(
+        boost::asio::ip::udp::socket& socket,
+        const boost::asio::ip::udp::endpoint& endpoint,
+        const std::vector<boost::asio::const_buffer>& datagrams
+    )
+    {
+        const auto total = datagrams.size() / 2;
+        if (!gso || total < 2)
+        {
+            return 0;
+        }
+
+        const auto segment = datagrams[0].size() + datagrams[1].size();
+        const auto per_call = std::clamp<std::size_t>(MAX_SEGMENTED / segment, 1, MAX_SEGMENTS);
+
+        std::size_t sent = 0;
+        while (sent < total)
+        {
+            const auto count = std::min(per_call, total - sent);
+            for (std::size_t i = 0; i < 2 * count; ++i)
+            {
+                const auto& part = datagrams[2 * sent + i];
+                w_iovecs[i] = {const_cast<void*>(part.data()), part.size()};
+            }
+
+            alignas(::cmsghdr) std::uint8_t control[CMSG_SPACE(sizeof(std::uint16_t))] = {};
+            ::msghdr message = {};
+            message.msg_name = const_cast<void*>(static_cast<const void*>(endpoint.data()));
+            message.msg_namelen = socklen_t(endpoint.size());
+            message.msg_iov = w_iovecs.data();
+            message.msg_iovlen = 2 * count;
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            auto* c = CMSG_FIRSTHDR(&message);
+            c->cmsg_level = IPPROTO_UDP;
+            c->cmsg_type = UDP_SEGMENT;
+            c->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+            const auto size = std::uint16_t(segment);
+            std::memcpy(CMSG_DATA(c), &size, sizeof(size));
+
+            if (::sendmsg(socket.native_handle(), &message, MSG_DONTWAIT) < 0)
+            {
+                // not supported by the kernel or the device, stop trying
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ENOBUFS)
+                {
+                    gso = false;
+                }
+                break;
+            }
+            sent += count;
+        }
+        return sent;
+    }
+#else
+    Batch::Batch(std::uint32_t init_capacity, std::uint64_t init_buffer, bool init_offload)
+        : capacity(init_capacity)
+        , buffer(init_buffer)
+        , offload(init_offload)
+        , gso(false)
+    {
+    }
+
+    bool Batch::coalesce(boost::asio::ip::udp::socket& /* socket */)
+    {
+        return false;
+    }
+
+    std::size_t Batch::receive(boost::asio::ip::udp::socket& /* socket */)
+    {
+        return 0;
+    }
+
+    std::size_t Batch::send(
+        boost::asio::ip::udp::socket& /* socket */,
+        boost::asio::const_buffer /* header */,
+        boost::asio::const_buffer /* body */,
+        const std::vector<const boost::asio::ip::udp::endpoint*>& /* endpoints */
+    )
+    {
+        return 0;
+    }
+
+    std::size_t Batch::send_segments(
+        boost::asio::ip::udp::socket& /* socket */,
+        const boost::asio::ip::udp::endpoint& /* endpoint */,
+        const std::vector<boost::asio::const_buffer>& /* datagrams */
+    )
+    {
+        return 0;
+    }
+#endif
+
+    bool Batch::coalescing() const
+    {
+        return gro;
+    }
+
+    bool Batch::segmenting() const
+    {
+        return gso;
+    }
+
+    const boost::asio::ip::udp::endpoint& Batch::endpoint(std::size_t index) const
+    {
+        return r_endpoints[r_views[index].slot];
+    }
+
+    const std::uint8_t* Batch::data(std::size_t index) const
+    {
+        const auto& view = r_views[index];
+        return r_data.data() + view.slot * buffer + view.offset;
+    }
+
+    std::uint64_t Batch::size(std::size_t index) const
+    {
+        return r_views[index].size;
+    }
+}
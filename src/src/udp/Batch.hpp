@@ -0,0 +1,119 @@
+#pragma once
+
+#include <boost/asio/ip/udp.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#endif
+
+namespace nil::service::udp
+{
+    /**
+     * @brief batched datagram I/O, one system call for several datagrams.
+     *  uses recvmmsg / sendmmsg on linux. elsewhere nothing is batched and
+     *  the callers keep sending / receiving one datagram per call.
+     *
+     *  with offload, consecutive same-size datagrams to a peer are handed to the
+     *  kernel as one buffer (UDP_SEGMENT) and datagrams of a peer coalesced by
+     *  the kernel (UDP_GRO) are split again when received. where the kernel
+     *  does not support it, datagrams are sent / received one by one.
+     */
+    class Batch final
+    {
+    public:
+#if defined(__linux__)
+        static constexpr bool SUPPORTED = true;
+#else
+        static constexpr bool SUPPORTED = false;
+#endif
+
+        Batch(std::uint32_t capacity, std::uint64_t buffer, bool offload);
+
+        Batch(Batch&&) noexcept = delete;
+        Batch(const Batch&) = delete;
+        Batch& operator=(Batch&&) noexcept = delete;
+        Batch& operator=(const Batch&) = delete;
+        ~Batch() noexcept = default;
+
+        /**
+         * @brief enables the receive offload of the socket (if requested).
+         *  to be called for every socket opened.
+         *
+         * @return true if the kernel coalesces the received datagrams.
+         *  these have to be received through `receive`.
+         */
+        bool coalesce(boost::asio::ip::udp::socket& socket);
+
+        [[nodiscard]] bool coalescing() const;
+
+        /**
+         * @return true if `send_segments` is worth trying (not known to be unsupported)
+         */
+        [[nodiscard]] bool segmenting() const;
+
+        /**
+         * @brief receives the datagrams already queued in the socket without blocking.
+         *
+         * @return number of datagrams received, accessible through `endpoint/data/size`
+         *  until the next call.
+         */
+        std::size_t receive(boost::asio::ip::udp::socket& socket);
+
+        [[nodiscard]] const boost::asio::ip::udp::endpoint& endpoint(std::size_t index) const;
+        [[nodiscard]] const std::uint8_t* data(std::size_t index) const;
+        [[nodiscard]] std::uint64_t size(std::size_t index) const;
+
+        /**
+         * @brief sends `header + body` to each of the endpoints without blocking.
+         *
+         * @return number of endpoints served. the rest is left to the caller.
+         */
+        std::size_t send(
+            boost::asio::ip::udp::socket& socket,
+            boost::asio::const_buffer header,
+            boost::asio::const_buffer body,
+            const std::vector<const boost::asio::ip::udp::endpoint*>& endpoints
+        );
+
+        /**
+         * @brief sends the datagrams to the endpoint using segmentation offload,
+         *  without blocking. `datagrams` holds a header and a body per datagram.
+         *  every datagram but the last must have the size of the first.
+         *
+         * @return number of datagrams sent. the rest is left to the caller.
+         */
+        std::size_t send_segments(
+            boost::asio::ip::udp::socket& socket,
+            const boost::asio::ip::udp::endpoint& endpoint,
+            const std::vector<boost::asio::const_buffer>& datagrams
+        );
+
+    private:
+        // a datagram within the receive slots, several per slot when coalesced
+        struct View final
+        {
+            std::size_t slot;
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+
+        std::uint32_t capacity;
+        std::uint64_t buffer;
+        bool offload;
+        bool gro = false;
+        bool gso;
+        std::vector<std::uint8_t> r_data;
+        std::vector<boost::asio::ip::udp::endpoint> r_endpoints;
+        std::vector<View> r_views;
+#if defined(__linux__)
+        std::vector<::mmsghdr> r_headers;
+        std::vector<::iovec> r_iovecs;
+        std::vector<std::uint8_t> r_controls;
+        std::vector<::mmsghdr> w_headers;
+        std::vector<::iovec> w_iovecs;
+#endif
+    };
+}
@@ -0,0 +1,152 @@
+#include "Fragments.hpp"
+
+#include <cstring>
+
+namespace nil::service::udp
+{
+    Reassembler::Reassembler(const Fragmentation& options)
+        : timeout(std::chrono::milliseconds(options.timeout_ms))
+        , max_bytes(options.max_bytes)
+        , max_pending(options.max_pending)
+    {
+    }
+
+    std::optional<std::vector<std::uint8_t>> Reassembler::add(
+        const void* peer,
+        const std::uint8_t* data,
+        std::uint64_t size,
+        clock::time_point now
+    )
+    {
+        if (size < FRAGMENT_HEADER_SIZE)
+        {
+            return std::nullopt;
+        }
+
+        const auto id = utils::from_array<std::uint32_t>(data + 1);
+        const auto index = utils::from_array<std::uint16_t>(data + 5);
+        const auto count = utils::from_array<std::uint16_t>(data + 7);
+        const auto offset = std::uint64_t(utils::from_array<std::uint32_t>(data + 9));
+        const auto* body = data + FRAGMENT_HEADER_SIZE;
+        const auto body_size = size - FRAGMENT_HEADER_SIZE;
+        if (index >= count)
+        {
+            return std::nullopt;
+        }
+
+        auto it = messages.find(Key{peer, id});
+        if (it == messages.end())
+        {
+            // a new message is charged its bookkeeping up front (the bitmap can be large)
+            const auto pending = pending_of.find(peer);
+            const auto cost = overhead(count);
+            if ((pending != pending_of.end() && pending->second >= max_pending)
+                || total + cost > max_bytes)
+            {
+                return std::nullopt;
+            }
+
+            ++pending_of[peer];
+            total += cost;
+            it = messages.try_emplace(Key{peer, id}).first;
+            auto& message = it->second;
+            message.received.resize(count);
+            message.remaining = count;
+            message.started = now;
+            message.charged = cost;
+        }
+        auto& message = it->second;
+        if (message.received.size() != count)
+        {
+            drop(it);
+            return std::nullopt;
+        }
+
+        if (message.received[index])
+        {
+            return std::nullopt;
+        }
+
+        // the size is only known once the last fragment arrived, grow as they come
+        const auto end = offset + body_size;
+        if (end > message.data.size())
+        {
+            const auto growth = end - message.data.size();
+            if (total + growth > max_bytes)
+            {
+                drop(it);
+                return std::nullopt;
+            }
+            total += growth;
+            message.charged += growth;
+            message.data.resize(end);
+        }
+
+        std::memcpy(message.data.data() + offset, body, body_size);
+        message.received[index] = true;
+        if (--message.remaining != 0)
+        {
+            return std::nullopt;
+        }
+
+        auto complete = std::move(message.data);
+        drop(it);
+        return complete;
+    }
+
+    void Reassembler::expire(clock::time_point now)
+    {
+        for (auto it = messages.begin(); it != messages.end();)
+        {
+            const auto current = it++;
+            if (now - current->second.started >= timeout)
+            {
+                drop(current);
+            }
+        }
+    }
+
+    void Reassembler::forget(const void* peer)
+    {
+        std::erase_if(
+            messages,
+            [this, peer](const auto& entry)
+            {
+                if (entry.first.peer != peer)
+                {
+                    return false;
+                }
+                total -= entry.second.charged;
+                return true;
+            }
+        );
+        pending_of.erase(peer);
+    }
+
+    std::size_t Reassembler::pending() const
+    {
+        return messages.size();
+    }
+
+    std::uint64_t Reassembler::bytes() const
+    {
+        return total;
+    }
+
+    void Reassembler::drop(std::unordered_map<Key, Message, KeyHash>::iterator it)
+    {
+        total -= it->second.charged;
+        const auto pending = pending_of.find(it->first.peer);
+        if (--pending->second == 0)
+        {
+            pending_of.erase(pending);
+        }
+        messages.erase(it);
+    }
+
+    std::uint64_t Reassembler::overhead(std::uint16_t count)
+    {
+        // entry of the map and bitmap of the received fragments
+        return sizeof(Key) + sizeof(Message) + (std::uint64_t(count) + 7) / 8;
+    }
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include "../utils.hpp"
+
+#include <nil/service/udp/fragmentation.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace nil::service::udp
+{
+    /**
+     * @brief header of a fragment:
+     *  marker | message id (u32) | fragment index (u16) | fragment count (u16) | offset (u32)
+     */
+    constexpr auto FRAGMENT_HEADER_SIZE = sizeof(std::uint8_t) + sizeof(std::uint32_t)
+        + sizeof(std::uint16_t) + sizeof(std::uint16_t) + sizeof(std::uint32_t);
+
+    using FragmentHeader = std::array<std::uint8_t, FRAGMENT_HEADER_SIZE>;
+
+    /**
+     * @return true if a payload of `size` bytes does not fit in a datagram of `mtu` bytes
+     */
+    inline bool needs_fragments(std::uint64_t mtu, std::uint64_t size)
+    {
+        return mtu != 0 && sizeof(utils::UDP_EXTERNAL_MESSAGE) + size > mtu;
+    }
+
+    /**
+     * @return bytes of the payload carried by each fragment
+     */
+    inline std::uint64_t fragment_chunk(std::uint64_t mtu)
+    {
+        return std::max<std::uint64_t>(mtu, FRAGMENT_HEADER_SIZE + 1) - FRAGMENT_HEADER_SIZE;
+    }
+
+    /**
+     * @return true if a payload of `size` bytes fits in the fragments the header can index
+     */
+    inline bool fits_fragments(std::uint64_t mtu, std::uint64_t size)
+    {
+        const auto chunk = fragment_chunk(mtu);
+        return (size + chunk - 1) / chunk <= std::numeric_limits<std::uint16_t>::max()
+            && size <= std::numeric_limits<std::uint32_t>::max();
+    }
+
+    /**
+     * @brief rejects, from the caller of publish/send, a payload that can not be sent.
+     *
+     * @throw std::length_error if the payload needs fragments it can not fit in
+     */
+    inline void check_fragments(std::uint64_t mtu, std::uint64_t size)
+    {
+        if (needs_fragments(mtu, size) && !fits_fragments(mtu, size))
+        {
+            throw std::length_error("payload too large for the udp fragments");
+        }
+    }
+
+    /**
+     * @brief calls `send(const_buffer header, const_buffer body)` for each fragment.
+     *  the header is only valid during the call.
+     *
+     * @return false (and nothing is sent) if the payload does not fit in the fragments
+     */
+    template <typename Send>
+    [[nodiscard]] bool split(
+        std::uint64_t mtu,
+        std::uint32_t id,
+        boost::asio::const_buffer payload,
+        Send&& send
+    )
+    {
+        if (!fits_fragments(mtu, payload.size()))
+        {
+            return false;
+        }
+
+        const auto chunk = fragment_chunk(mtu);
+        const auto count = std::max<std::uint64_t>((payload.size() + chunk - 1) / chunk, 1);
+
+        FragmentHeader header{};
+        header[0] = utils::UDP_FRAGMENT_MESSAGE;
+        const auto write = [&header](std::size_t position, const auto& field)
+        { std::copy(field.begin(), field.end(), header.begin() + position); };
+        write(1, utils::to_array(id));
+        write(7, utils::to_array(std::uint16_t(count)));
+
+        const auto* data = static_cast<const std::uint8_t*>(payload.data());
+        for (std::uint64_t index = 0; index < count; ++index)
+        {
+            const auto offset = index * chunk;
+            write(5, utils::to_array(std::uint16_t(index)));
+            write(9, utils::to_array(std::uint32_t(offset)));
+            send(
+                boost::asio::buffer(header),
+                boost::asio::buffer(data + offset, std::min(chunk, payload.size() - offset))
+            );
+        }
+        return true;
+    }
+
+    /**
+     * @brief collects the fragments of the messages of several peers.
+     *  incomplete messages are kept until `expire` is called past their timeout
+     *  or until they would exceed the memory cap. the cap covers the data and
+     *  the bookkeeping of each message, a peer has at most `max_pending` of them.
+     */
+    class Reassembler final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit Reassembler(const Fragmentation& options);
+
+        /**
+         * @brief adds a fragment (header included) sent by `peer`.
+         *
+         * @return the message if the fragment completed it
+         */
+        std::optional<std::vector<std::uint8_t>> add(
+            const void* peer,
+            const std::uint8_t* data,
+            std::uint64_t size,
+            clock::time_point now
+        );
+
+        /**
+         * @brief drops the incomplete messages older than the timeout.
+         */
+        void expire(clock::time_point now);
+
+        /**
+         * @brief drops the incomplete messages of the peer.
+         */
+        void forget(const void* peer);
+
+        [[nodiscard]] std::size_t pending() const;
+        [[nodiscard]] std::uint64_t bytes() const;
+
+    private:
+        struct Key final
+        {
+            const void* peer;
+            std::uint32_t id;
+
+            bool operator==(const Key&) const = default;
+        };
+
+        struct KeyHash final
+        {
+            std::size_t operator()(const Key& key) const
+            {
+                return std::hash<const void*>()(key.peer) ^ (std::size_t(key.id) << 1);
+            }
+        };
+
+        struct Message final
+        {
+            std::vector<std::uint8_t> data;
+            std::vector<bool> received;
+            std::uint16_t remaining = 0;
+            clock::time_point started;
+            // bytes counted against the cap: data and bookkeeping
+            std::uint64_t charged = 0;
+        };
+
+        clock::duration timeout;
+        std::uint64_t max_bytes;
+        std::uint32_t max_pending;
+        std::uint64_t total = 0;
+        std::unordered_map<Key, Message, KeyHash> messages;
+        // messages being reassembled per peer
+        std::unordered_map<const void*, std::uint32_t> pending_of;
+
+        static std::uint64_t overhead(std::uint16_t count);
+
+        void drop(std::unordered_map<Key, Message, KeyHash>::iterator it);
+    };
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "../utils.hpp"
+
+#include <nil/service/udp/reliability.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace nil::service::udp
+{
+    /**
+     * @brief header of a reliable datagram, followed by the wrapped datagram:
+     *  marker | session (u32) | sequence (u32)
+     */
+    constexpr auto RELIABLE_HEADER_SIZE
+        = sizeof(std::uint8_t) + sizeof(std::uint32_t) + sizeof(std::uint32_t);
+
+    /**
+     * @brief acknowledgement of the reliable datagrams:
+     *  marker | session (u32) | next expected sequence (u32) | selective ack (u64)
+     *  bit `i` of the selective ack is set when `next + 1 + i` was received.
+     *  the missing datagrams below the highest bit set are retransmitted early.
+     */
+    constexpr auto ACK_SIZE = sizeof(std::uint8_t) + sizeof(std::uint32_t)
+        + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+    using ReliableHeader = std::array<std::uint8_t, RELIABLE_HEADER_SIZE>;
+    using Ack = std::array<std::uint8_t, ACK_SIZE>;
+
+    /**
+     * @return the room left for the wrapped datagram when a reliable datagram has to fit `mtu`
+     */
+    inline std::uint64_t wrapped_mtu(std::uint64_t mtu, bool reliable)
+    {
+        if (mtu == 0 || !reliable)
+        {
+            return mtu;
+        }
+        return std::max<std::uint64_t>(mtu, RELIABLE_HEADER_SIZE + 1) - RELIABLE_HEADER_SIZE;
+    }
+
+    /**
+     * @brief reliable, ordered stream of datagrams to and from one peer.
+     *
+     *  sending: datagrams are numbered and kept until acknowledged, at most
+     *  `window` in flight. they are retransmitted after the retransmission
+     *  timeout (RFC 6298 estimation, doubled on each timeout) or as soon as the
+     *  peer acknowledges later ones.
+     *
+     *  receiving: datagrams are delivered in sequence order. those ahead of a
+     *  missing one are buffered (up to `window`). every datagram is answered
+     *  with an acknowledgement.
+     *
+     *  a session id distinguishes the streams of a peer that restarted.
+     */
+    class ReliableChannel final
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit ReliableChannel(const Reliability& options)
+            : window(std::max(options.window, 1u))
+            , min_rto(std::chrono::milliseconds(options.min_rto_ms))
+            , max_rto(std::max<clock::duration>(
+                  min_rto,
+                  std::chrono::milliseconds(options.max_rto_ms)
+              ))
+            , rto(std::clamp<clock::duration>(INITIAL_RTO, min_rto, max_rto))
+            , session(std::random_device()())
+        {
+        }
+
+        /**
+         * @brief queues the datagram and calls `send(const_buffer header, const_buffer datagram)`
+         *  for the datagrams the window allows.
+         */
+        template <typename Send>
+        void push(std::vector<std::uint8_t> datagram, clock::time_point now, Send&& send)
+        {
+            queued.push_back(std::move(datagram));
+            fill(now, send);
+        }
+
+        /**
+         * @brief handles an acknowledgement of the peer (marker included).
+         */
+        template <typename Send>
+        void acknowledge(
+            const std::uint8_t* data,
+            std::uint64_t size,
+            clock::time_point now,
+            Send&& send
+        )
+        {
+            if (size < ACK_SIZE || utils::from_array<std::uint32_t>(data + 1) != session)
+            {
+                return;
+            }
+
+            const auto next = utils::from_array<std::uint32_t>(data + 5);
+            const auto selective = utils::from_array<std::uint64_t>(data + 9);
+
+            while (!flight.empty() && after(next, base))
+            {
+                sample(flight.front(), now);
+                flight.pop_front();
+                ++base;
+            }
+
+            std::uint32_t highest = next;
+            for (auto bit = 0u; bit < 64u; ++bit)
+            {
+                if ((selective & (std::uint64_t(1) << bit)) != 0)
+                {
+                    highest = next + 1 + bit;
+                    if (auto* entry = find(highest))
+                    {
+                        sample(*entry, now);
+                        entry->acked = true;
+                    }
+                }
+            }
+
+            // the holes under a datagram that arrived are most likely lost
+            const auto holes = after(highest, base)
+                ? std::min<std::size_t>(std::uint32_t(highest - base), flight.size())
+                : 0;
+            for (std::size_t i = 0; i < holes; ++i)
+            {
+                auto& entry = flight[i];
+                if (!entry.acked && now - entry.sent >= srtt.value_or(rto))
+                {
+                    resend(base + std::uint32_t(i), entry, now, send);
+                }
+            }
+
+            fill(now, send);
+        }
+
+        /**
+         * @brief retransmits the datagrams that were not acknowledged in time.
+         */
+        template <typename Send>
+        void retransmit(clock::time_point now, Send&& send)
+        {
+            auto expired = false;
+            for (std::size_t i = 0; i < flight.size(); ++i)
+            {
+                auto& entry = flight[i];
+                if (!entry.acked && now - entry.sent >= rto)
+                {
+                    resend(base + std::uint32_t(i), entry, now, send);
+                    expired = true;
+                }
+            }
+
+            if (expired)
+            {
+                rto = std::min(2 * rto, max_rto);
+            }
+        }
+
+        /**
+         * @brief handles a reliable datagram of the peer (marker included).
+         *  calls `deliver(const std::uint8_t*, std::uint64_t)` with the wrapped datagrams
+         *  that are next in sequence. the data is only valid during the call.
+         *
+         * @return the acknowledgement to send back
+         */
+        template <typename Deliver>
+        std::optional<Ack> receive(const std::uint8_t* data, std::uint64_t size, Deliver&& deliver)
+        {
+            if (size < RELIABLE_HEADER_SIZE)
+            {
+                return std::nullopt;
+            }
+
+            const auto peer = utils::from_array<std::uint32_t>(data + 1);
+            const auto sequence = utils::from_array<std::uint32_t>(data + 5);
+            if (!peer_session || *peer_session != peer)
+            {
+                peer_session = peer;
+                expected = 0;
+                pending.assign(window, std::nullopt);
+            }
+
+            const auto distance = std::uint32_t(sequence - expected);
+            if (!after(expected, sequence) && distance < window)
+            {
+                const auto* body = data + RELIABLE_HEADER_SIZE;
+                const auto body_size = size - RELIABLE_HEADER_SIZE;
+                if (distance == 0)
+                {
+                    ++expected;
+                    deliver(body, body_size);
+                    while (auto& slot = pending[expected % window])
+                    {
+                        const auto next = std::move(*slot);
+                        slot.reset();
+                        ++expected;
+                        deliver(next.data(), next.size());
+                    }
+                }
+                else if (auto& slot = pending[sequence % window]; !slot)
+                {
+                    slot.emplace(body, body + body_size);
+                }
+            }
+
+            return make_ack();
+        }
+
+        /**
+         * @return true if every datagram sent was acknowledged
+         */
+        [[nodiscard]] bool idle() const
+        {
+            return flight.empty() && queued.empty();
+        }
+
+        [[nodiscard]] clock::duration timeout() const
+        {
+            return rto;
+        }
+
+    private:
+        struct Entry final
+        {
+            std::vector<std::uint8_t> datagram;
+            clock::time_point sent;
+            bool retransmitted = false;
+            bool acked = false;
+        };
+
+        static constexpr auto INITIAL_RTO = std::chrono::milliseconds(100);
+
+        std::uint32_t window;
+        clock::duration min_rto;
+        clock::duration max_rto;
+        clock::duration rto;
+        std::optional<clock::duration> srtt;
+        clock::duration rttvar{};
+
+        // sending
+        std::uint32_t session;
+        std::uint32_t base = 0;
+        std::deque<Entry> flight;
+        std::deque<std::vector<std::uint8_t>> queued;
+
+        // receiving
+        std::optional<std::uint32_t> peer_session;
+        std::uint32_t expected = 0;
+        std::vector<std::optional<std::vector<std::uint8_t>>> pending;
+
+        // serial number arithmetic, handles the wrap around
+        static bool after(std::uint32_t a, std::uint32_t b)
+        {
+            return std::int32_t(a - b) > 0;
+        }
+
+        Entry* find(std::uint32_t sequence)
+        {
+            const auto index = std::uint32_t(sequence - base);
+            return index < flight.size() ? &flight[index] : nullptr;
+        }
+
+        template <typename Send>
+        void fill(clock::time_point now, Send& send)
+        {
+            while (!queued.empty() && flight.size() < window)
+            {
+                auto& entry = flight.emplace_back(Entry{std::move(queued.front()), now});
+                queued.pop_front();
+                transmit(base + std::uint32_t(flight.size() - 1), entry, send);
+            }
+        }
+
+        template <typename Send>
+        void resend(std::uint32_t sequence, Entry& entry, clock::time_point now, Send& send)
+        {
+            entry.sent = now;
+            entry.retransmitted = true;
+            transmit(sequence, entry, send);
+        }
+
+        template <typename Send>
+        void transmit(std::uint32_t sequence, const Entry& entry, Send& send)
+        {
+            ReliableHeader header{};
+            header[0] = utils::UDP_RELIABLE_MESSAGE;
+            const auto s = utils::to_array(session);
+            const auto q = utils::to_array(sequence);
+            std::copy(s.begin(), s.end(), header.begin() + 1);
+            std::copy(q.begin(), q.end(), header.begin() + 5);
+            send(boost::asio::buffer(header), boost::asio::buffer(entry.datagram));
+        }
+
+        // round trip estimation (RFC 6298), skipping retransmitted datagrams (Karn)
+        void sample(const Entry& entry, clock::time_point now)
+        {
+            if (entry.acked || entry.retransmitted)
+            {
+                return;
+            }
+
+            const auto rtt = now - entry.sent;
+            if (!srtt)
+            {
+                srtt = rtt;
+                rttvar = rtt / 2;
+            }
+            else
+            {
+                const auto delta = *srtt > rtt ? *srtt - rtt : rtt - *srtt;
+                rttvar = (3 * rttvar + delta) / 4;
+                srtt = (7 * *srtt + rtt) / 8;
+            }
+            rto = std::clamp(*srtt + 4 * rttvar, min_rto, max_rto);
+        }
+
+        [[nodiscard]] Ack make_ack() const
+        {
+            std::uint64_t selective = 0;
+            for (auto bit = 0u; bit < 64u && bit + 1 < window; ++bit)
+            {
+                if (pending[(expected + 1 + bit) % window])
+                {
+                    selective |= std::uint64_t(1) << bit;
+                }
+            }
+
+            Ack ack{};
+            ack[0] = utils::UDP_ACK_MESSAGE;
+            const auto s = utils::to_array(*peer_session);
+            const auto n = utils::to_array(expected);
+            const auto b = utils::to_array(selective);
+            std::copy(s.begin(), s.end(), ack.begin() + 1);
+            std::copy(n.begin(), n.end(), ack.begin() + 5);
+            std::copy(b.begin(), b.end(), ack.begin() + 9);
+            return ack;
+        }
+    };
+}
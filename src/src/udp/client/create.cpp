@@ -1,6 +1,11 @@
 #include <nil/service/udp/client/create.hpp>
 
+#include "../../Pieces.hpp"
+#include "../../ReceiveBuffer.hpp"
 #include "../../utils.hpp"
+#include "../Batch.hpp"
+#include "../Fragments.hpp"
+#include "../Reliable.hpp"
 
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
@@ -18,16 +23,21 @@ namespace nil::service::udp::client
         explicit Context()
             : strand(make_strand(ctx))
             , socket(strand)
+            , resolver(strand)
             , pingtimer(strand)
             , timeout(strand)
+            , resend(strand)
         {
         }
 
         boost::asio::io_context ctx;
-        boost::asio::strand<boost::asio::io_context::executor_type> strand = make_strand(ctx);
+        boost::asio::strand<boost::asio::io_context::executor_type> strand;
         boost::asio::ip::udp::socket socket;
+        boost::asio::ip::udp::resolver resolver;
         boost::asio::steady_timer pingtimer;
         boost::asio::steady_timer timeout;
+        boost::asio::steady_timer resend;
+        bool resending = false;
     };
 
     struct Impl final: IStandaloneService
@@ -47,13 +57,15 @@ namespace nil::service::udp::client
         explicit Impl(Options init_options)
             : options(std::move(init_options))
             , context(std::make_unique<Context>())
+            , reassembly(options.fragmentation)
+            , channel(options.reliability)
         {
-            buffer.resize(options.buffer);
-            if (open_socket())
+            if (Batch::SUPPORTED && options.offload)
             {
-                ping();
-                receive();
+                batch = std::make_unique<Batch>(1, options.buffer, true);
             }
+            buffer = ReceiveBuffer(options.buffer);
+            connect();
         }
 
         ~Impl() noexcept override = default;
@@ -82,12 +94,9 @@ namespace nil::service::udp::client
         void restart() override
         {
             context = std::make_unique<Context>();
-            buffer.resize(options.buffer);
-            if (open_socket())
-            {
-                ping();
-                receive();
-            }
+            channel = ReliableChannel(options.reliability);
+            buffer = ReceiveBuffer(options.buffer);
+            connect();
         }
 
         void dispatch(std::function<void()> task) override
@@ -95,16 +104,18 @@ namespace nil::service::udp::client
             boost::asio::dispatch(context->ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
+            check_fragments(mtu(), data.size());
             boost::asio::post(
                 context->strand,
                 [this, msg = std::move(data)]() { send_external(msg); }
             );
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
+            check_fragments(mtu(), data.size());
             boost::asio::post(
                 context->strand,
                 [this, ids = std::move(ids), msg = std::move(data)]()
@@ -118,7 +129,7 @@ namespace nil::service::udp::client
             );
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
             auto it = std::find(ids.begin(), ids.end(), ID{this, this, &Impl::to_string_remote});
             if (it != ids.end())
@@ -127,44 +138,153 @@ namespace nil::service::udp::client
             }
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
     private:
         Options options;
+        Pieces pieces;
         std::unique_ptr<Context> context;
 
-        std::vector<std::uint8_t> buffer;
+        ReceiveBuffer buffer;
 
+        // resolved on each (re)connect
+        boost::asio::ip::udp::endpoint remote;
         bool connected = false;
 
+        std::uint32_t next_message = 0;
+        Reassembler reassembly;
+        ReliableChannel channel;
+        std::unique_ptr<Batch> batch;
+        std::vector<FragmentHeader> fragments;
+        std::vector<boost::asio::const_buffer> segments;
+
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
 
-        [[nodiscard]] bool open_socket()
+        /**
+         * @brief resolves the server and starts probing it.
+         *  a failed resolution or socket setup is retried after the probe interval.
+         */
+        void connect()
         {
             boost::system::error_code ec;
             const auto address = boost::asio::ip::make_address(options.host, ec);
-            if (ec)
+            if (!ec)
             {
-                return false;
+                start({address, options.port});
+                return;
             }
 
-            context->socket.open(
-                address.is_v6() ? boost::asio::ip::udp::v6() : boost::asio::ip::udp::v4(),
-                ec
+            context->resolver.async_resolve(
+                options.host,
+                std::to_string(options.port),
+                [this](
+                    const boost::system::error_code& rec,
+                    const boost::asio::ip::udp::resolver::results_type& results
+                )
+                {
+                    if (rec == boost::asio::error::operation_aborted)
+                    {
+                        return;
+                    }
+
+                    if (rec || results.empty())
+                    {
+                        retry();
+                        return;
+                    }
+
+                    start(results.begin()->endpoint());
+                }
+            );
+        }
+
+        void retry()
+        {
+            context->pingtimer.expires_after(std::chrono::milliseconds(options.probe_interval_ms));
+            context->pingtimer.async_wait(
+                [this](const boost::system::error_code& ec)
+                {
+                    if (ec != boost::asio::error::operation_aborted)
+                    {
+                        connect();
+                    }
+                }
             );
+        }
+
+        void start(boost::asio::ip::udp::endpoint endpoint)
+        {
+            remote = std::move(endpoint);
+            if (!open_socket())
+            {
+                // a half opened socket would fail the next attempt too
+                boost::system::error_code ec;
+                context->socket.close(ec);
+                retry();
+                return;
+            }
+
+            ping();
+            receive();
+        }
+
+        [[nodiscard]] bool open_socket()
+        {
+            boost::system::error_code ec;
+            context->socket.open(remote.protocol(), ec);
             if (ec)
             {
                 return false;
             }
 
             context->socket.set_option(boost::asio::socket_base::reuse_address(true), ec);
-            return !ec;
+            if (ec)
+            {
+                return false;
+            }
+
+            if (options.connect)
+            {
+                context->socket.connect(remote, ec);
+                if (ec)
+                {
+                    return false;
+                }
+            }
+
+            if (batch)
+            {
+                batch->coalesce(context->socket);
+            }
+            return true;
         }
 
-        [[nodiscard]] boost::asio::ip::udp::endpoint remote_endpoint() const
+        /**
+         * @brief sends to the server. errors are ignored like lost datagrams.
+         */
+        template <typename Buffers>
+        void send_remote(const Buffers& buffers)
         {
-            return {boost::asio::ip::make_address(options.host), options.port};
+            boost::system::error_code ec;
+            if (options.connect)
+            {
+                context->socket.send(buffers, 0, ec);
+            }
+            else
+            {
+                context->socket.send_to(buffers, remote, 0, ec);
+            }
         }
 
         [[nodiscard]] bool contains_remote_id(const std::vector<ID>& ids) const
@@ -173,15 +293,132 @@ namespace nil::service::udp::client
                 != std::find(ids.begin(), ids.end(), ID{this, this, &Impl::to_string_remote});
         }
 
-        void send_external(const std::vector<std::uint8_t>& msg)
+        [[nodiscard]] std::uint64_t mtu() const
+        {
+            return wrapped_mtu(options.fragmentation.mtu, options.reliability.enabled);
+        }
+
+        void send_external(const Payload& msg)
         {
-            const auto marker = utils::to_array(utils::UDP_EXTERNAL_MESSAGE);
-            context->socket.send_to(
-                std::array<boost::asio::const_buffer, 2>{
-                    boost::asio::buffer(marker),
-                    boost::asio::buffer(msg)
-                },
-                remote_endpoint()
+            const auto send = [this](auto header, auto body)
+            {
+                if (options.reliability.enabled)
+                {
+                    send_reliable(header, body);
+                }
+                else
+                {
+                    send_datagram(header, body);
+                }
+            };
+
+            const auto payload = boost::asio::buffer(msg.data(), msg.size());
+            const auto mtu = this->mtu();
+            if (needs_fragments(mtu, msg.size()))
+            {
+                if (!options.reliability.enabled && batch && batch->segmenting())
+                {
+                    send_segmented(mtu, payload);
+                }
+                else
+                {
+                    // always true: publish/send reject the payloads the fragments can not carry
+                    [[maybe_unused]] const auto fits = split(mtu, next_message++, payload, send);
+                }
+            }
+            else
+            {
+                const auto marker = utils::to_array(utils::UDP_EXTERNAL_MESSAGE);
+                send(boost::asio::buffer(marker), payload);
+            }
+        }
+
+        /**
+         * @brief sends the fragments of the payload in one go (UDP_SEGMENT).
+         */
+        void send_segmented(std::uint64_t mtu, boost::asio::const_buffer payload)
+        {
+            const auto fits = split(
+                mtu,
+                next_message++,
+                payload,
+                [this](boost::asio::const_buffer header, boost::asio::const_buffer body)
+                {
+                    auto& fragment = fragments.emplace_back();
+                    boost::asio::buffer_copy(boost::asio::buffer(fragment), header);
+                    // the header is pointed to once every fragment is stored
+                    segments.emplace_back();
+                    segments.push_back(body);
+                }
+            );
+            if (!fits)
+            {
+                return;
+            }
+            for (std::size_t i = 0; i < fragments.size(); ++i)
+            {
+                segments[2 * i] = boost::asio::buffer(fragments[i]);
+            }
+
+            auto sent = batch->send_segments(context->socket, remote, segments);
+            // whatever could not be sent without blocking (or is not supported)
+            for (; sent < fragments.size(); ++sent)
+            {
+                send_datagram(segments[2 * sent], segments[2 * sent + 1]);
+            }
+
+            fragments.clear();
+            segments.clear();
+        }
+
+        void send_datagram(boost::asio::const_buffer header, boost::asio::const_buffer body)
+        {
+            send_remote(std::array<boost::asio::const_buffer, 2>{header, body});
+        }
+
+        void send_reliable(boost::asio::const_buffer header, boost::asio::const_buffer body)
+        {
+            std::vector<std::uint8_t> datagram(header.size() + body.size());
+            boost::asio::buffer_copy(
+                boost::asio::buffer(datagram),
+                std::array<boost::asio::const_buffer, 2>{header, body}
+            );
+            channel.push(
+                std::move(datagram),
+                std::chrono::steady_clock::now(),
+                [this](auto h, auto b) { send_datagram(h, b); }
+            );
+            retransmit();
+        }
+
+        void retransmit()
+        {
+            if (context->resending)
+            {
+                return;
+            }
+
+            context->resending = true;
+            const auto interval = std::chrono::milliseconds(options.reliability.min_rto_ms) / 2;
+            context->resend.expires_after(std::max(interval, std::chrono::milliseconds(1)));
+            context->resend.async_wait(
+                [this](const boost::system::error_code& ec)
+                {
+                    if (ec)
+                    {
+                        return;
+                    }
+
+                    context->resending = false;
+                    if (!channel.idle())
+                    {
+                        channel.retransmit(
+                            std::chrono::steady_clock::now(),
+                            [this](auto h, auto b) { send_datagram(h, b); }
+                        );
+                        retransmit();
+                    }
+                }
             );
         }
 
@@ -198,7 +435,7 @@ namespace nil::service::udp::client
                 utils::invoke(on_ready_cb, ID{this, this, &Impl::to_string_local});
                 utils::invoke(on_connect_cb, ID{this, this, &Impl::to_string_remote});
             }
-            context->timeout.expires_after(std::chrono::milliseconds(utils::PROBE_INTERVAL_MS * 2));
+            context->timeout.expires_after(std::chrono::milliseconds(options.timeout_ms));
             context->timeout.async_wait(
                 [this](const boost::system::error_code& ec)
                 {
@@ -209,6 +446,8 @@ namespace nil::service::udp::client
                     if (connected)
                     {
                         connected = false;
+                        // the server drops its side of the stream, start a new one
+                        channel = ReliableChannel(options.reliability);
                         utils::invoke(on_disconnect_cb, ID{this, this, &Impl::to_string_remote});
                         recreate_socket();
                     }
@@ -221,42 +460,126 @@ namespace nil::service::udp::client
             boost::system::error_code ec;
             context->socket.cancel(ec);
             context->socket.close(ec);
-
-            if (!open_socket())
-            {
-                return;
-            }
-
-            receive();
+            connect();
         }
 
         void message(const std::uint8_t* data, std::uint64_t size)
         {
             if (size >= sizeof(std::uint8_t))
             {
-                if (utils::from_array<std::uint8_t>(data) > 0u)
+                switch (utils::from_array<std::uint8_t>(data))
                 {
-                    pong();
+                    case utils::UDP_INTERNAL_MESSAGE:
+                        pong();
+                        break;
+                    case utils::UDP_RELIABLE_MESSAGE:
+                    {
+                        const auto ack = channel.receive(
+                            data,
+                            size,
+                            [this](const std::uint8_t* d, std::uint64_t s) { deliver(d, s); }
+                        );
+                        if (ack)
+                        {
+                            send_remote(boost::asio::buffer(*ack));
+                        }
+                        break;
+                    }
+                    case utils::UDP_ACK_MESSAGE:
+                        channel.acknowledge(
+                            data,
+                            size,
+                            std::chrono::steady_clock::now(),
+                            [this](auto h, auto b) { send_datagram(h, b); }
+                        );
+                        break;
+                    default:
+                        deliver(data, size);
+                        break;
                 }
-                else
-                {
+            }
+        }
+
+        /**
+         * @brief hands a message of the server to the user, reassembling fragments.
+         */
+        void deliver(const std::uint8_t* data, std::uint64_t size)
+        {
+            if (size < sizeof(std::uint8_t))
+            {
+                return;
+            }
+
+            switch (utils::from_array<std::uint8_t>(data))
+            {
+                case utils::UDP_EXTERNAL_MESSAGE:
                     usermsg(data + sizeof(std::uint8_t), size - sizeof(std::uint8_t));
+                    break;
+                case utils::UDP_FRAGMENT_MESSAGE:
+                {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (auto msg = reassembly.add(this, data, size, now))
+                    {
+                        usermsg(msg->data(), msg->size());
+                    }
+                    break;
                 }
+                default:
+                    break;
             }
         }
 
         void receive()
         {
+            if (batch && batch->coalescing())
+            {
+                // coalesced datagrams can only be split with what recvmmsg reports
+                context->socket.async_wait(
+                    boost::asio::socket_base::wait_read,
+                    [this](const boost::system::error_code& ec)
+                    {
+                        if (ec)
+                        {
+                            return;
+                        }
+
+                        const auto count = batch->receive(context->socket);
+                        for (auto i = 0u; i < count; ++i)
+                        {
+                            message(batch->data(i), batch->size(i));
+                        }
+                        receive();
+                    }
+                );
+                return;
+            }
+
+            if (buffer.lent())
+            {
+                // a handler kept the previous datagram
+                buffer.relocate(buffer.size(), 0, 0);
+            }
+
             context->socket.async_receive(
-                boost::asio::buffer(buffer),
+                boost::asio::buffer(buffer.data(), buffer.size()),
                 [this](const boost::system::error_code& ec, std::size_t count)
                 {
+                    // a connected socket reports the unreachable server, keep listening
+                    if (ec == boost::asio::error::connection_refused)
+                    {
+                        receive();
+                        return;
+                    }
+
                     if (ec)
                     {
                         return;
                     }
 
-                    message(buffer.data(), count);
+                    {
+                        const auto lend = buffer.lend();
+                        message(buffer.data(), count);
+                    }
                     receive();
                 }
             );
@@ -264,11 +587,9 @@ namespace nil::service::udp::client
 
         void ping()
         {
-            context->socket.send_to(
-                boost::asio::buffer(utils::to_array(utils::UDP_INTERNAL_MESSAGE)),
-                {boost::asio::ip::make_address(options.host), options.port}
-            );
-            context->pingtimer.expires_after(std::chrono::milliseconds(utils::PROBE_INTERVAL_MS));
+            reassembly.expire(std::chrono::steady_clock::now());
+            send_remote(boost::asio::buffer(utils::to_array(utils::UDP_INTERNAL_MESSAGE)));
+            context->pingtimer.expires_after(std::chrono::milliseconds(options.probe_interval_ms));
             context->pingtimer.async_wait(
                 [this](const boost::system::error_code& ec)
                 {
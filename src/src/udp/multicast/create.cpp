@@ -0,0 +1,454 @@
+#include <nil/service/udp/multicast/create.hpp>
+
+#include "../../Pieces.hpp"
+#include "../../ReceiveBuffer.hpp"
+#include "../../Registry.hpp"
+#include "../../TimingWheel.hpp"
+#include "../../utils.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/multicast.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace nil::service::udp::multicast
+{
+    // marker | id of the publishing service (u32)
+    constexpr auto HEADER_SIZE = sizeof(std::uint8_t) + sizeof(std::uint32_t);
+
+    /**
+     * @brief a member of the group that published to it.
+     */
+    struct Member final
+    {
+        boost::asio::ip::udp::endpoint endpoint;
+        // time of the last datagram
+        std::chrono::steady_clock::time_point last_seen;
+
+        explicit Member(boost::asio::ip::udp::endpoint init_endpoint)
+            : endpoint(std::move(init_endpoint))
+        {
+        }
+
+        static std::string to_string(const void* c)
+        {
+            return utils::to_id(static_cast<const Member*>(c)->endpoint);
+        }
+    };
+
+    /**
+     * @brief datagrams of a socket being received.
+     */
+    struct Inbox final
+    {
+        boost::asio::ip::udp::socket socket;
+        ReceiveBuffer buffer;
+        boost::asio::ip::udp::endpoint sender;
+    };
+
+    struct Context
+    {
+        explicit Context(const Options& options)
+            : strand(make_strand(ctx))
+            , group{boost::asio::ip::udp::socket(strand), ReceiveBuffer(options.buffer), {}}
+            , unicast{boost::asio::ip::udp::socket(strand), ReceiveBuffer(options.buffer), {}}
+            , liveness(timeout(options) / SWEEPS_PER_TIMEOUT, timeout(options))
+            , sweep(strand)
+        {
+        }
+
+        boost::asio::io_context ctx;
+        boost::asio::strand<boost::asio::io_context::executor_type> strand;
+        // bound to the group port, shared by the members of the host
+        Inbox group;
+        // bound to an ephemeral port: publishes and identifies the member.
+        // replies sent to the member arrive here.
+        Inbox unicast;
+        // forgets the members that stopped publishing
+        TimingWheel<Member> liveness;
+        boost::asio::steady_timer sweep;
+        bool sweeping = false;
+
+        // granularity of the expiration
+        static constexpr auto SWEEPS_PER_TIMEOUT = 4;
+
+        static std::chrono::milliseconds timeout(const Options& options)
+        {
+            return std::chrono::milliseconds(std::max(options.member_timeout_ms, 1u));
+        }
+    };
+
+    struct Impl final: IStandaloneService
+    {
+        static std::string to_string_local(const void* c)
+        {
+            const auto& socket = static_cast<const Impl*>(c)->context->unicast.socket;
+            return utils::to_id(socket.local_endpoint());
+        }
+
+        static std::string to_string_group(const void* c)
+        {
+            const auto* impl = static_cast<const Impl*>(c);
+            return impl->options.group + ":" + std::to_string(impl->options.port);
+        }
+
+    public:
+        explicit Impl(Options init_options)
+            : options(std::move(init_options))
+            , context(std::make_unique<Context>(options))
+            , header(make_header(std::random_device()()))
+        {
+            join();
+            receive(context->group);
+            receive(context->unicast);
+        }
+
+        ~Impl() noexcept override = default;
+
+        Impl(Impl&&) noexcept = delete;
+        Impl& operator=(Impl&&) noexcept = delete;
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+
+        void run() override
+        {
+            auto _ = boost::asio::make_work_guard(context->ctx);
+            context->ctx.run();
+        }
+
+        void poll() override
+        {
+            context->ctx.poll();
+        }
+
+        void stop() override
+        {
+            context->ctx.stop();
+        }
+
+        void restart() override
+        {
+            context = std::make_unique<Context>(options);
+            members = {};
+            sources.clear();
+            join();
+            receive(context->group);
+            receive(context->unicast);
+        }
+
+        void dispatch(std::function<void()> task) override
+        {
+            boost::asio::dispatch(context->ctx, std::move(task));
+        }
+
+        void publish(Payload data) override
+        {
+            boost::asio::post(
+                context->strand,
+                [this, msg = std::move(data)]() { send_to(group, msg); }
+            );
+        }
+
+        void publish_ex(std::vector<ID> ids, Payload data) override
+        {
+            boost::asio::post(
+                context->strand,
+                [this, ids = std::move(ids), msg = std::move(data)]()
+                {
+                    // a single datagram reaches every member, none can be left out
+                    if (std::find(ids.begin(), ids.end(), group_id()) != ids.end())
+                    {
+                        return;
+                    }
+                    send_to(group, msg);
+                }
+            );
+        }
+
+        void send(std::vector<ID> ids, Payload data) override
+        {
+            boost::asio::post(
+                context->strand,
+                [this, ids = std::move(ids), msg = std::move(data)]()
+                {
+                    for (const auto& id : ids)
+                    {
+                        if (id == group_id())
+                        {
+                            send_to(group, msg);
+                        }
+                        else if (id.owner == this)
+                        {
+                            if (const auto* member = members.find(id.id))
+                            {
+                                send_to(member->endpoint, msg);
+                            }
+                        }
+                    }
+                }
+            );
+        }
+
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
+    private:
+        Options options;
+        Pieces pieces;
+        std::unique_ptr<Context> context;
+
+        // identifies the datagrams of this service when looped back
+        std::array<std::uint8_t, HEADER_SIZE> header;
+        boost::asio::ip::udp::endpoint group;
+
+        Registry<Member> members;
+        std::unordered_map<boost::asio::ip::udp::endpoint, Member*, utils::EndpointHash> sources;
+
+        std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID)>> on_ready_cb;
+        std::vector<std::function<void(ID)>> on_connect_cb;
+        std::vector<std::function<void(ID)>> on_disconnect_cb;
+
+        static std::array<std::uint8_t, HEADER_SIZE> make_header(std::uint32_t instance)
+        {
+            std::array<std::uint8_t, HEADER_SIZE> retval{};
+            retval[0] = utils::UDP_EXTERNAL_MESSAGE;
+            const auto bytes = utils::to_array(instance);
+            std::copy(bytes.begin(), bytes.end(), retval.begin() + 1);
+            return retval;
+        }
+
+        [[nodiscard]] ID group_id() const
+        {
+            return ID{this, this, &Impl::to_string_group};
+        }
+
+        /**
+         * @brief opens the sockets and joins the group.
+         *  throws (like a failed bind of the other services) if any step fails.
+         */
+        void join()
+        {
+            const auto address = boost::asio::ip::make_address(options.group);
+            if (!address.is_multicast())
+            {
+                throw std::invalid_argument("not a multicast address: " + options.group);
+            }
+
+            auto local = address.is_v6()
+                ? boost::asio::ip::address(boost::asio::ip::address_v6::any())
+                : boost::asio::ip::address(boost::asio::ip::address_v4::any());
+            if (!options.interface_address.empty())
+            {
+                local = boost::asio::ip::make_address(options.interface_address);
+                if (local.is_v6() != address.is_v6())
+                {
+                    throw std::invalid_argument(
+                        "interface and group of different families: " + options.interface_address
+                    );
+                }
+            }
+
+            const auto protocol
+                = address.is_v6() ? boost::asio::ip::udp::v6() : boost::asio::ip::udp::v4();
+
+            // every member on the host binds the group port
+            auto& listener = context->group.socket;
+            listener.open(protocol);
+            listener.set_option(boost::asio::socket_base::reuse_address(true));
+            listener.bind({protocol, options.port});
+
+            namespace mc = boost::asio::ip::multicast;
+            auto& publisher = context->unicast.socket;
+            publisher.open(protocol);
+            if (address.is_v6())
+            {
+                const auto scope = static_cast<unsigned int>(local.to_v6().scope_id());
+                listener.set_option(mc::join_group(address.to_v6(), scope));
+                publisher.set_option(mc::outbound_interface(scope));
+            }
+            else
+            {
+                listener.set_option(mc::join_group(address.to_v4(), local.to_v4()));
+                publisher.set_option(mc::outbound_interface(local.to_v4()));
+            }
+            publisher.set_option(mc::hops(options.ttl));
+            publisher.set_option(mc::enable_loopback(options.loopback));
+            publisher.bind({local, 0});
+
+            group = {address, options.port};
+            boost::asio::post(
+                context->strand,
+                [this]()
+                {
+                    utils::invoke(on_ready_cb, ID{this, this, &Impl::to_string_local});
+                    utils::invoke(on_connect_cb, group_id());
+                }
+            );
+        }
+
+        void send_to(const boost::asio::ip::udp::endpoint& endpoint, const Payload& msg)
+        {
+            // errors are ignored like lost datagrams
+            boost::system::error_code ec;
+            context->unicast.socket.send_to(
+                std::array<boost::asio::const_buffer, 2>{
+                    boost::asio::buffer(header),
+                    boost::asio::buffer(msg.data(), msg.size())
+                },
+                endpoint,
+                0,
+                ec
+            );
+        }
+
+        void message(
+            const boost::asio::ip::udp::endpoint& sender,
+            const std::uint8_t* data,
+            std::uint64_t size
+        )
+        {
+            if (size < HEADER_SIZE || data[0] != utils::UDP_EXTERNAL_MESSAGE)
+            {
+                return;
+            }
+
+            // looped back datagram of this service
+            if (std::equal(header.begin(), header.end(), data))
+            {
+                return;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            auto it = sources.find(sender);
+            if (it == sources.end())
+            {
+                auto& member = members.add(std::make_unique<Member>(sender));
+                it = sources.emplace(sender, &member).first;
+                context->liveness.schedule(&member, now + Context::timeout(options));
+                sweep();
+            }
+            // the wheel checks it once the member is due
+            it->second->last_seen = now;
+
+            utils::invoke(
+                on_message_cb,
+                ID{this, it->second, &Member::to_string},
+                data + HEADER_SIZE,
+                size - HEADER_SIZE
+            );
+        }
+
+        void sweep()
+        {
+            if (context->sweeping)
+            {
+                return;
+            }
+
+            context->sweeping = true;
+            context->sweep.expires_after(context->liveness.interval());
+            context->sweep.async_wait(
+                [this](const boost::system::error_code& ec)
+                {
+                    if (ec)
+                    {
+                        return;
+                    }
+
+                    context->sweeping = false;
+                    const auto now = std::chrono::steady_clock::now();
+                    const auto timeout = Context::timeout(options);
+                    context->liveness.advance(
+                        now,
+                        [&](Member* member)
+                        {
+                            if (now - member->last_seen < timeout)
+                            {
+                                context->liveness.schedule(member, member->last_seen + timeout);
+                                return;
+                            }
+
+                            utils::invoke(on_disconnect_cb, ID{this, member, &Member::to_string});
+                            sources.erase(member->endpoint);
+                            members.remove(member);
+                        }
+                    );
+
+                    if (!context->liveness.empty())
+                    {
+                        sweep();
+                    }
+                }
+            );
+        }
+
+        void receive(Inbox& inbox)
+        {
+            if (inbox.buffer.lent())
+            {
+                // a handler kept the previous datagram
+                inbox.buffer.relocate(inbox.buffer.size(), 0, 0);
+            }
+
+            inbox.socket.async_receive_from(
+                boost::asio::buffer(inbox.buffer.data(), inbox.buffer.size()),
+                inbox.sender,
+                [this, &inbox](const boost::system::error_code& ec, std::size_t count)
+                {
+                    if (ec)
+                    {
+                        return;
+                    }
+
+                    {
+                        const auto lend = inbox.buffer.lend();
+                        message(inbox.sender, inbox.buffer.data(), count);
+                    }
+                    receive(inbox);
+                }
+            );
+        }
+
+        void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
+        {
+            on_message_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_ready(std::function<void(ID)> handler) override
+        {
+            on_ready_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_connect(std::function<void(ID)> handler) override
+        {
+            on_connect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_disconnect(std::function<void(ID)> handler) override
+        {
+            on_disconnect_cb.push_back(std::move(handler));
+        }
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options)
+    {
+        return std::make_unique<Impl>(std::move(options));
+    }
+}
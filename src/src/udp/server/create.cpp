@@ -1,6 +1,13 @@
 #include <nil/service/udp/server/create.hpp>
 
+#include "../../Pieces.hpp"
+#include "../../ReceiveBuffer.hpp"
+#include "../../Registry.hpp"
+#include "../../TimingWheel.hpp"
 #include "../../utils.hpp"
+#include "../Batch.hpp"
+#include "../Fragments.hpp"
+#include "../Reliable.hpp"
 
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
@@ -10,41 +17,148 @@
 
 #include <algorithm>
 #include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace nil::service::udp::server
 {
-    struct Context
+    struct Connection final
     {
-        explicit Context(const std::string& host, std::uint16_t port)
+        boost::asio::ip::udp::endpoint endpoint;
+        // time of the last probe
+        std::chrono::steady_clock::time_point last_seen;
+        ReliableChannel channel;
+
+        Connection(boost::asio::ip::udp::endpoint init_endpoint, const Reliability& reliability)
+            : endpoint(std::move(init_endpoint))
+            , channel(reliability)
+        {
+        }
+
+        static std::string to_string(const void* c)
+        {
+            return utils::to_id(static_cast<const Connection*>(c)->endpoint);
+        }
+    };
+
+    /**
+     * @brief an io_context with its socket and the peers it serves.
+     *  each shard is run by its own thread.
+     */
+    struct Shard final
+    {
+        explicit Shard(const Options& options)
             : strand(make_strand(ctx))
-            , socket(strand, {boost::asio::ip::make_address(host), port})
+            , socket(strand)
+            , buffer(options.buffer)
+            , mtu(wrapped_mtu(options.fragmentation.mtu, options.reliability.enabled))
+            , reassembly(options.fragmentation)
+            , reliability(options.reliability)
+            , resend(strand)
+            , liveness(timeout(options) / SWEEPS_PER_TIMEOUT, timeout(options))
+            , sweep(strand)
         {
-            socket.set_option(boost::asio::socket_base::reuse_address(true));
+            if (Batch::SUPPORTED && (options.batch > 1 || options.offload))
+            {
+                batch = std::make_unique<Batch>(options.batch, options.buffer, options.offload);
+            }
         }
 
         boost::asio::io_context ctx;
         boost::asio::strand<boost::asio::io_context::executor_type> strand;
         boost::asio::ip::udp::socket socket;
+        Registry<Connection> connections;
+        std::unordered_map<boost::asio::ip::udp::endpoint, Connection*, utils::EndpointHash> peers;
+        ReceiveBuffer buffer;
+        std::unique_ptr<Batch> batch;
+        // destinations of the payload being sent
+        std::vector<Connection*> targets;
+        std::vector<const boost::asio::ip::udp::endpoint*> endpoints;
+        // fragments of the payload being sent with segmentation offload
+        std::vector<FragmentHeader> fragments;
+        std::vector<boost::asio::const_buffer> segments;
+        std::uint64_t mtu;
+        std::uint32_t next_message = 0;
+        Reassembler reassembly;
+        Reliability reliability;
+        // retransmits what the peers did not acknowledge in time
+        boost::asio::steady_timer resend;
+        bool resending = false;
+        // expires the peers that stopped probing
+        TimingWheel<Connection> liveness;
+        boost::asio::steady_timer sweep;
+        bool sweeping = false;
+
+        // granularity of the expiration
+        static constexpr auto SWEEPS_PER_TIMEOUT = 4;
+
+        static std::chrono::milliseconds timeout(const Options& options)
+        {
+            return std::chrono::milliseconds(options.timeout_ms);
+        }
+    };
+
+    struct Context
+    {
+        explicit Context(const Options& options)
+            : shards(make_shards(options))
+        {
+            const auto share_port = shards.size() > 1;
+            auto endpoint = boost::asio::ip::udp::endpoint(
+                boost::asio::ip::make_address(options.host),
+                options.port
+            );
+            for (const auto& shard : shards)
+            {
+                utils::bind(shard->socket, endpoint, share_port);
+                if (shard->batch)
+                {
+                    shard->batch->coalesce(shard->socket);
+                }
+                // the rest binds to the same port even if an ephemeral one was requested
+                endpoint = shard->socket.local_endpoint();
+            }
+        }
+
+        std::vector<std::unique_ptr<Shard>> shards;
+
+        Shard& main()
+        {
+            return *shards.front();
+        }
+
+        static std::vector<std::unique_ptr<Shard>> make_shards(const Options& options)
+        {
+            const auto count = utils::HAS_REUSE_PORT ? std::max(options.threads, 1u) : 1u;
+            std::vector<std::unique_ptr<Shard>> shards;
+            shards.reserve(count);
+            while (shards.size() < count)
+            {
+                shards.push_back(std::make_unique<Shard>(options));
+            }
+            return shards;
+        }
     };
 
     struct Impl final: IStandaloneService
     {
         static std::string to_string(const void* c)
         {
-            return utils::to_id(static_cast<const Impl*>(c)->context->socket.local_endpoint());
+            const auto& socket = static_cast<const Impl*>(c)->context->main().socket;
+            return utils::to_id(socket.local_endpoint());
         }
 
     public:
         explicit Impl(Options init_options)
             : options(std::move(init_options))
-            , context(std::make_unique<Context>(options.host, options.port))
+            , context(std::make_unique<Context>(options))
         {
-            buffer.resize(options.buffer);
             boost::asio::post(
-                context->ctx,
+                context->main().ctx,
                 [this]() { utils::invoke(on_ready_cb, ID{this, this, &Impl::to_string}); }
             );
-            receive();
+            receive_all();
         }
 
         ~Impl() noexcept override = default;
@@ -57,182 +171,435 @@ namespace nil::service::udp::server
 
         void run() override
         {
-            auto _ = boost::asio::make_work_guard(context->ctx);
-            context->ctx.run();
+            const auto& shards = context->shards;
+            std::vector<std::thread> threads;
+            threads.reserve(shards.size() - 1);
+            for (auto it = std::next(shards.begin()); it != shards.end(); ++it)
+            {
+                threads.emplace_back([shard = it->get()]() { run_shard(*shard); });
+            }
+            run_shard(*shards.front());
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
         }
 
         void poll() override
         {
-            context->ctx.poll();
+            for (const auto& shard : context->shards)
+            {
+                shard->ctx.poll();
+            }
         }
 
         void stop() override
         {
-            context->ctx.stop();
+            for (const auto& shard : context->shards)
+            {
+                shard->ctx.stop();
+            }
         }
 
         void restart() override
         {
-            context = std::make_unique<Context>(options.host, options.port);
+            context.reset();
+            context = std::make_unique<Context>(options);
             boost::asio::post(
-                context->ctx,
+                context->main().ctx,
                 [this]() { utils::invoke(on_ready_cb, ID{this, this, &Impl::to_string}); }
             );
-            receive();
+            receive_all();
         }
 
         void dispatch(std::function<void()> task) override
         {
-            boost::asio::dispatch(context->ctx, std::move(task));
+            boost::asio::dispatch(context->main().ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, msg = std::move(data)]()
-                {
-                    for (const auto& connection : connections)
+            check_fragments(mtu(), data.size());
+            for (const auto& shard : context->shards)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard.get(), msg = data]()
                     {
-                        send_external(connection->endpoint, msg);
+                        for (const auto& connection : shard->connections)
+                        {
+                            shard->targets.push_back(connection.get());
+                        }
+                        send_external(*shard, msg);
                     }
-                }
-            );
+                );
+            }
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
-                {
-                    for (const auto& connection : connections)
+            check_fragments(mtu(), data.size());
+            auto excluded = std::make_shared<const std::unordered_set<const void*>>(to_keys(ids));
+            for (const auto& shard : context->shards)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard.get(), excluded, msg = data]()
                     {
-                        if (has_connection_id(ids, connection.get()))
+                        for (const auto& connection : shard->connections)
                         {
-                            continue;
-                        }
+                            if (excluded->contains(connection.get()))
+                            {
+                                continue;
+                            }
 
-                        send_external(connection->endpoint, msg);
+                            shard->targets.push_back(connection.get());
+                        }
+                        send_external(*shard, msg);
                     }
-                }
-            );
+                );
+            }
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
-            boost::asio::post(
-                context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
-                {
-                    for (const auto& connection : connections)
+            check_fragments(mtu(), data.size());
+            // the shard of a peer is picked by the kernel so every shard looks it up
+            auto keys = std::make_shared<const std::unordered_set<const void*>>(to_keys(ids));
+            for (const auto& shard : context->shards)
+            {
+                boost::asio::post(
+                    shard->strand,
+                    [shard = shard.get(), keys, msg = data]()
                     {
-                        if (has_connection_id(ids, connection.get()))
+                        for (const auto* key : *keys)
                         {
-                            send_external(connection->endpoint, msg);
+                            if (auto* connection = shard->connections.find(key))
+                            {
+                                shard->targets.push_back(connection);
+                            }
                         }
+                        send_external(*shard, msg);
                     }
-                }
-            );
+                );
+            }
         }
 
-    private:
-        struct Connection final
+        void publish_some(Payload piece, bool last) override
         {
-            boost::asio::ip::udp::endpoint endpoint;
-            boost::asio::steady_timer timer;
-
-            Connection(
-                boost::asio::ip::udp::endpoint init_endpoint,
-                boost::asio::strand<boost::asio::io_context::executor_type>& strand
-            )
-                : endpoint(std::move(init_endpoint))
-                , timer(strand)
-            {
-            }
+            pieces.publish_some(*this, std::move(piece), last);
+        }
 
-            static std::string to_string(const void* c)
-            {
-                return utils::to_id(static_cast<const Connection*>(c)->endpoint);
-            }
-        };
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
 
+    private:
         Options options;
+        Pieces pieces;
         std::unique_ptr<Context> context;
-        std::vector<std::unique_ptr<Connection>> connections;
-        std::vector<std::uint8_t> buffer;
 
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
 
-        [[nodiscard]] bool has_connection_id(
-            const std::vector<ID>& ids,
-            const Connection* connection
-        ) const
+        static void run_shard(Shard& shard)
+        {
+            auto _ = boost::asio::make_work_guard(shard.ctx);
+            shard.ctx.run();
+        }
+
+        [[nodiscard]] std::unordered_set<const void*> to_keys(const std::vector<ID>& ids) const
         {
-            return ids.end()
-                != std::find_if(
-                       ids.begin(),
-                       ids.end(),
-                       [&](const auto& id) { return id.owner == this && id.id == connection; }
+            std::unordered_set<const void*> keys;
+            for (const auto& id : ids)
+            {
+                if (id.owner == this)
+                {
+                    keys.emplace(id.id);
+                }
+            }
+            return keys;
+        }
+
+        [[nodiscard]] std::uint64_t mtu() const
+        {
+            return wrapped_mtu(options.fragmentation.mtu, options.reliability.enabled);
+        }
+
+        static auto sender(Shard& shard, const Connection& connection)
+        {
+            return [&shard, &connection](auto header, auto body)
+            {
+                shard.socket.send_to(
+                    std::array<boost::asio::const_buffer, 2>{header, body},
+                    connection.endpoint
                 );
+            };
         }
 
-        void send_external(
-            const boost::asio::ip::udp::endpoint& endpoint,
-            const std::vector<std::uint8_t>& msg
+        /**
+         * @brief sends the payload to `shard.targets`.
+         */
+        static void send_external(Shard& shard, const Payload& msg)
+        {
+            const auto send = [&shard](auto header, auto body)
+            {
+                if (shard.reliability.enabled)
+                {
+                    send_reliable(shard, header, body);
+                }
+                else
+                {
+                    send_datagram(shard, header, body);
+                }
+            };
+
+            const auto payload = boost::asio::buffer(msg.data(), msg.size());
+            const auto fragmented = needs_fragments(shard.mtu, msg.size());
+            if (fragmented && !shard.reliability.enabled && shard.batch
+                && shard.batch->segmenting())
+            {
+                send_segmented(shard, payload);
+                shard.targets.clear();
+                return;
+            }
+
+            if (shard.batch && !shard.reliability.enabled)
+            {
+                for (const auto* connection : shard.targets)
+                {
+                    shard.endpoints.push_back(&connection->endpoint);
+                }
+            }
+
+            if (fragmented)
+            {
+                // always true: publish/send reject the payloads the fragments can not carry
+                [[maybe_unused]] const auto fits
+                    = split(shard.mtu, shard.next_message++, payload, send);
+            }
+            else
+            {
+                const auto header = utils::to_array(utils::UDP_EXTERNAL_MESSAGE);
+                send(boost::asio::buffer(header), payload);
+            }
+            shard.targets.clear();
+            shard.endpoints.clear();
+        }
+
+        static void send_datagram(
+            Shard& shard,
+            boost::asio::const_buffer header,
+            boost::asio::const_buffer body
         )
         {
-            const auto header = utils::to_array(utils::UDP_EXTERNAL_MESSAGE);
-            context->socket.send_to(
-                std::array<boost::asio::const_buffer, 2>{
-                    boost::asio::buffer(header),
-                    boost::asio::buffer(msg)
-                },
-                endpoint
-            );
+            std::size_t sent = 0;
+            if (shard.batch)
+            {
+                sent = shard.batch->send(shard.socket, header, body, shard.endpoints);
+            }
+
+            // whatever the batch could not send without blocking
+            for (auto i = sent; i < shard.targets.size(); ++i)
+            {
+                shard.socket.send_to(
+                    std::array<boost::asio::const_buffer, 2>{header, body},
+                    shard.targets[i]->endpoint
+                );
+            }
         }
 
-        void ping(const boost::asio::ip::udp::endpoint& endpoint, Connection* connection)
+        /**
+         * @brief sends the fragments of the payload to each target in one go (UDP_SEGMENT).
+         */
+        static void send_segmented(Shard& shard, boost::asio::const_buffer payload)
         {
-            if (connection == nullptr)
+            const auto fits = split(
+                shard.mtu,
+                shard.next_message++,
+                payload,
+                [&shard](boost::asio::const_buffer header, boost::asio::const_buffer body)
+                {
+                    auto& fragment = shard.fragments.emplace_back();
+                    boost::asio::buffer_copy(boost::asio::buffer(fragment), header);
+                    // the header is pointed to once every fragment is stored
+                    shard.segments.emplace_back();
+                    shard.segments.push_back(body);
+                }
+            );
+            if (!fits)
             {
-                connections.emplace_back(std::make_unique<Connection>(endpoint, context->strand));
-                connection = connections.back().get();
-                utils::invoke(on_connect_cb, ID{this, connection, &Connection::to_string});
+                return;
+            }
+            for (std::size_t i = 0; i < shard.fragments.size(); ++i)
+            {
+                shard.segments[2 * i] = boost::asio::buffer(shard.fragments[i]);
+            }
+
+            for (const auto* connection : shard.targets)
+            {
+                const auto& endpoint = connection->endpoint;
+                auto sent = shard.batch->send_segments(shard.socket, endpoint, shard.segments);
+                // whatever could not be sent without blocking (or is not supported)
+                for (; sent < shard.fragments.size(); ++sent)
+                {
+                    shard.socket.send_to(
+                        std::array<boost::asio::const_buffer, 2>{
+                            shard.segments[2 * sent],
+                            shard.segments[2 * sent + 1]
+                        },
+                        endpoint
+                    );
+                }
             }
 
-            connection->timer.expires_after(std::chrono::milliseconds(utils::PROBE_INTERVAL_MS * 2)
+            shard.fragments.clear();
+            shard.segments.clear();
+        }
+
+        /**
+         * @brief hands the datagram to the reliable channel of each target.
+         */
+        static void send_reliable(
+            Shard& shard,
+            boost::asio::const_buffer header,
+            boost::asio::const_buffer body
+        )
+        {
+            std::vector<std::uint8_t> datagram(header.size() + body.size());
+            boost::asio::buffer_copy(
+                boost::asio::buffer(datagram),
+                std::array<boost::asio::const_buffer, 2>{header, body}
             );
-            connection->timer.async_wait(
-                [this, connection](const boost::system::error_code& ec)
+
+            const auto now = std::chrono::steady_clock::now();
+            for (auto* connection : shard.targets)
+            {
+                connection->channel.push(datagram, now, sender(shard, *connection));
+            }
+            retransmit(shard);
+        }
+
+        static void retransmit(Shard& shard)
+        {
+            if (shard.resending)
+            {
+                return;
+            }
+
+            shard.resending = true;
+            const auto interval = std::chrono::milliseconds(shard.reliability.min_rto_ms) / 2;
+            shard.resend.expires_after(std::max(interval, std::chrono::milliseconds(1)));
+            shard.resend.async_wait(
+                [&shard](const boost::system::error_code& ec)
                 {
-                    if (ec == boost::asio::error::operation_aborted)
+                    if (ec)
                     {
                         return;
                     }
-                    utils::invoke(on_disconnect_cb, ID{this, connection, &Connection::to_string});
-                    connections.erase(
-                        std::remove_if(
-                            connections.begin(),
-                            connections.end(),
-                            [&](const std::unique_ptr<Connection>& cc)
-                            { return connection == cc.get(); }
-                        ),
-                        connections.end()
-                    );
+
+                    shard.resending = false;
+                    const auto now = std::chrono::steady_clock::now();
+                    auto busy = false;
+                    for (const auto& connection : shard.connections)
+                    {
+                        if (!connection->channel.idle())
+                        {
+                            connection->channel.retransmit(now, sender(shard, *connection));
+                            busy = true;
+                        }
+                    }
+
+                    if (busy)
+                    {
+                        retransmit(shard);
+                    }
                 }
             );
+        }
 
-            context->socket.send_to(
+        void ping(
+            Shard& shard,
+            const boost::asio::ip::udp::endpoint& endpoint,
+            Connection* connection
+        )
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (connection == nullptr)
+            {
+                connection = &shard.connections.add(
+                    std::make_unique<Connection>(endpoint, options.reliability)
+                );
+                shard.peers.emplace(endpoint, connection);
+                shard.liveness.schedule(connection, now + Shard::timeout(options));
+                sweep(shard);
+                utils::invoke(on_connect_cb, ID{this, connection, &Connection::to_string});
+            }
+
+            // the wheel checks it once the connection is due
+            connection->last_seen = now;
+
+            shard.socket.send_to(
                 boost::asio::buffer(utils::to_array(utils::UDP_INTERNAL_MESSAGE)),
                 endpoint
             );
         }
 
+        void sweep(Shard& shard)
+        {
+            if (shard.sweeping)
+            {
+                return;
+            }
+
+            shard.sweeping = true;
+            shard.sweep.expires_after(shard.liveness.interval());
+            shard.sweep.async_wait(
+                [this, &shard](const boost::system::error_code& ec)
+                {
+                    if (ec)
+                    {
+                        return;
+                    }
+
+                    shard.sweeping = false;
+                    const auto now = std::chrono::steady_clock::now();
+                    const auto timeout = Shard::timeout(options);
+                    shard.reassembly.expire(now);
+                    shard.liveness.advance(
+                        now,
+                        [&](Connection* connection)
+                        {
+                            if (now - connection->last_seen < timeout)
+                            {
+                                shard.liveness.schedule(
+                                    connection,
+                                    connection->last_seen + timeout
+                                );
+                                return;
+                            }
+
+                            const auto id = ID{this, connection, &Connection::to_string};
+                            utils::invoke(on_disconnect_cb, id);
+                            shard.reassembly.forget(connection);
+                            shard.peers.erase(connection->endpoint);
+                            shard.connections.remove(connection);
+                        }
+                    );
+
+                    if (!shard.liveness.empty())
+                    {
+                        sweep(shard);
+                    }
+                }
+            );
+        }
+
         void message(
+            Shard& shard,
             const boost::asio::ip::udp::endpoint& endpoint,
             const std::uint8_t* data,
             std::uint64_t size
@@ -240,52 +607,165 @@ namespace nil::service::udp::server
         {
             if (size >= sizeof(std::uint8_t))
             {
-                auto it = std::find_if(
-                    connections.begin(),
-                    connections.end(),
-                    [&](const auto& connection) { return connection->endpoint == endpoint; }
-                );
-                auto* connection = (it == connections.end()) ? nullptr : it->get();
+                const auto it = shard.peers.find(endpoint);
+                auto* connection = (it == shard.peers.end()) ? nullptr : it->second;
 
                 if (utils::from_array<std::uint8_t>(data) == utils::UDP_INTERNAL_MESSAGE)
                 {
-                    ping(endpoint, connection);
+                    ping(shard, endpoint, connection);
                     return;
                 }
 
-                if (connection != nullptr)
+                if (connection == nullptr)
                 {
+                    return;
+                }
+
+                switch (utils::from_array<std::uint8_t>(data))
+                {
+                    case utils::UDP_RELIABLE_MESSAGE:
+                    {
+                        const auto ack = connection->channel.receive(
+                            data,
+                            size,
+                            [&](const std::uint8_t* d, std::uint64_t s)
+                            { deliver(shard, connection, d, s); }
+                        );
+                        if (ack)
+                        {
+                            shard.socket.send_to(boost::asio::buffer(*ack), endpoint);
+                        }
+                        break;
+                    }
+                    case utils::UDP_ACK_MESSAGE:
+                        connection->channel.acknowledge(
+                            data,
+                            size,
+                            std::chrono::steady_clock::now(),
+                            sender(shard, *connection)
+                        );
+                        break;
+                    default:
+                        deliver(shard, connection, data, size);
+                        break;
+                }
+            }
+        }
+
+        /**
+         * @brief hands a message of the peer to the user, reassembling fragments.
+         */
+        void deliver(
+            Shard& shard,
+            Connection* connection,
+            const std::uint8_t* data,
+            std::uint64_t size
+        )
+        {
+            if (size < sizeof(std::uint8_t))
+            {
+                return;
+            }
+
+            const auto id = ID{this, connection, &Connection::to_string};
+            switch (utils::from_array<std::uint8_t>(data))
+            {
+                case utils::UDP_EXTERNAL_MESSAGE:
                     utils::invoke(
                         on_message_cb,
-                        ID{this, connection, &Connection::to_string},
+                        id,
                         data + sizeof(std::uint8_t),
                         size - sizeof(std::uint8_t)
                     );
+                    break;
+                case utils::UDP_FRAGMENT_MESSAGE:
+                {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (auto msg = shard.reassembly.add(connection, data, size, now))
+                    {
+                        utils::invoke(on_message_cb, id, msg->data(), msg->size());
+                    }
+                    break;
                 }
+                default:
+                    break;
+            }
+        }
+
+        void receive_all()
+        {
+            for (const auto& shard : context->shards)
+            {
+                receive(*shard);
             }
         }
 
-        void receive()
+        void receive(Shard& shard)
         {
+            if (shard.batch && shard.batch->coalescing())
+            {
+                // coalesced datagrams can only be split with what recvmmsg reports
+                shard.socket.async_wait(
+                    boost::asio::socket_base::wait_read,
+                    [this, &shard](const boost::system::error_code& ec)
+                    {
+                        if (!ec)
+                        {
+                            receive_batch(shard);
+                            receive(shard);
+                        }
+                    }
+                );
+                return;
+            }
+
+            if (shard.buffer.lent())
+            {
+                // a handler kept the previous datagram
+                shard.buffer.relocate(shard.buffer.size(), 0, 0);
+            }
+
             auto receiver = std::make_unique<boost::asio::ip::udp::endpoint>();
             auto& capture = *receiver;
-            context->socket.async_receive_from(
-                boost::asio::buffer(buffer),
+            shard.socket.async_receive_from(
+                boost::asio::buffer(shard.buffer.data(), shard.buffer.size()),
                 capture,
-                [this, receiver = std::move(receiver)](
+                [this, &shard, receiver = std::move(receiver)](
                     const boost::system::error_code& ec,
                     std::size_t count //
                 )
                 {
                     if (!ec)
                     {
-                        message(*receiver, buffer.data(), count);
-                        receive();
+                        {
+                            const auto lend = shard.buffer.lend();
+                            message(shard, *receiver, shard.buffer.data(), count);
+                        }
+                        receive_batch(shard);
+                        receive(shard);
                     }
                 }
             );
         }
 
+        /**
+         * @brief drains the datagrams that are already queued after a wakeup.
+         */
+        void receive_batch(Shard& shard)
+        {
+            if (!shard.batch)
+            {
+                return;
+            }
+
+            auto& batch = *shard.batch;
+            const auto count = batch.receive(shard.socket);
+            for (auto i = 0u; i < count; ++i)
+            {
+                message(shard, batch.endpoint(i), batch.data(i), batch.size(i));
+            }
+        }
+
         void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
         {
             on_message_cb.push_back(std::move(handler));
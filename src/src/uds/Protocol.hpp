@@ -0,0 +1,102 @@
+#pragma once
+
+#include <boost/asio/generic/seq_packet_protocol.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+namespace nil::service::uds
+{
+    using Stream = boost::asio::local::stream_protocol;
+    // local::seq_packet_protocol is only provided by recent boost versions
+    using SeqPacket = boost::asio::generic::seq_packet_protocol;
+
+    template <typename Protocol>
+    typename Protocol::endpoint make_endpoint(const std::string& path)
+    {
+        // the generic endpoint copies the AF_UNIX address of the local one
+        return typename Protocol::endpoint(Stream::endpoint(path));
+    }
+
+    /**
+     * @brief removes the socket file left behind by a server that is gone:
+     *  only a socket where a connection of `type` is refused.
+     *  anything else (a regular file, a listening server) stays and fails the bind.
+     */
+    inline void remove_stale(const std::string& path, int type)
+    {
+        struct stat info = {};
+        if (::lstat(path.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode))
+        {
+            return;
+        }
+
+        sockaddr_un address = {};
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            return;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        const int probe = ::socket(AF_UNIX, type, 0);
+        if (probe < 0)
+        {
+            return;
+        }
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto* generic = reinterpret_cast<const sockaddr*>(&address);
+        const bool refused
+            = ::connect(probe, generic, sizeof(address)) != 0 && errno == ECONNREFUSED;
+        ::close(probe);
+        if (refused)
+        {
+            ::unlink(path.c_str());
+        }
+    }
+
+    /**
+     * @brief the socket file created by a server, removed with it
+     *  unless the path was replaced in the meantime.
+     */
+    class SocketFile final
+    {
+    public:
+        explicit SocketFile(std::string init_path)
+            : path(std::move(init_path))
+        {
+            struct stat info = {};
+            if (::lstat(path.c_str(), &info) == 0)
+            {
+                device = info.st_dev;
+                inode = info.st_ino;
+            }
+        }
+
+        ~SocketFile() noexcept
+        {
+            struct stat info = {};
+            if (::lstat(path.c_str(), &info) == 0 && info.st_dev == device && info.st_ino == inode)
+            {
+                ::unlink(path.c_str());
+            }
+        }
+
+        SocketFile(SocketFile&&) = delete;
+        SocketFile(const SocketFile&) = delete;
+        SocketFile& operator=(SocketFile&&) = delete;
+        SocketFile& operator=(const SocketFile&) = delete;
+
+    private:
+        std::string path;
+        dev_t device = 0;
+        ino_t inode = 0;
+    };
+}
@@ -0,0 +1,306 @@
+#include <nil/service/uds/client/create.hpp>
+
+#include "../../Pieces.hpp"
+#include "../../tcp/Connection.hpp"
+#include "../../utils.hpp"
+#include "../Protocol.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace nil::service::uds::client
+{
+    struct Context
+    {
+        explicit Context()
+            : strand(make_strand(ctx))
+            , reconnection(strand)
+        {
+        }
+
+        boost::asio::io_context ctx;
+        boost::asio::strand<boost::asio::io_context::executor_type> strand;
+        boost::asio::steady_timer reconnection;
+    };
+
+    template <typename Protocol>
+    struct Impl final
+        : IStandaloneService
+        , ConnectedImpl<tcp::BasicConnection<Protocol>>
+    {
+        using Connection = tcp::BasicConnection<Protocol>;
+
+    public:
+        explicit Impl(Options init_options)
+            : options(std::move(init_options))
+            , outbound(options.backpressure)
+            , context(std::make_unique<Context>())
+        {
+            connect();
+        }
+
+        ~Impl() override = default;
+
+        Impl(Impl&&) noexcept = delete;
+        Impl& operator=(Impl&&) noexcept = delete;
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+
+        void run() override
+        {
+            auto _ = boost::asio::make_work_guard(context->ctx);
+            context->ctx.run();
+        }
+
+        void poll() override
+        {
+            context->ctx.poll();
+        }
+
+        void stop() override
+        {
+            outbound.release(true);
+            context->ctx.stop();
+        }
+
+        void restart() override
+        {
+            outbound.release(false);
+            context = std::make_unique<Context>();
+            connect();
+        }
+
+        void dispatch(std::function<void()> task) override
+        {
+            boost::asio::post(context->ctx, std::move(task));
+        }
+
+        void publish(Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), msg = std::move(data)]()
+                { write_if_connected(msg); }
+            );
+        }
+
+        void publish_ex(std::vector<ID> ids, Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
+                {
+                    if (!has_remote_id(ids))
+                    {
+                        write_if_connected(msg);
+                    }
+                }
+            );
+        }
+
+        void send(std::vector<ID> ids, Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
+                {
+                    if (has_remote_id(ids))
+                    {
+                        write_if_connected(msg);
+                    }
+                }
+            );
+        }
+
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
+    private:
+        Options options;
+        Pieces pieces;
+        Outbound outbound;
+        std::unique_ptr<Context> context;
+        std::unique_ptr<Connection> connection;
+
+        std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID)>> on_ready_cb;
+        std::vector<std::function<void(ID)>> on_connect_cb;
+        std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
+
+        [[nodiscard]] bool in_service_thread() const
+        {
+            return context->ctx.get_executor().running_in_this_thread();
+        }
+
+        [[nodiscard]] bool has_remote_id(const std::vector<ID>& ids) const
+        {
+            if (connection == nullptr)
+            {
+                return false;
+            }
+            return ids.end() != std::find(ids.begin(), ids.end(), connection->remote_id());
+        }
+
+        void write_if_connected(const Payload& msg)
+        {
+            if (connection != nullptr)
+            {
+                connection->write(msg);
+            }
+        }
+
+        void connect(Connection* target_connection) override
+        {
+            utils::invoke(on_connect_cb, target_connection->remote_id());
+        }
+
+        void disconnect(Connection* target_connection) override
+        {
+            boost::asio::post(
+                context->strand,
+                [this, target_connection]()
+                {
+                    if (connection.get() == target_connection)
+                    {
+                        utils::invoke(on_disconnect_cb, connection->remote_id());
+                        connection.reset();
+                    }
+                    reconnect();
+                }
+            );
+        }
+
+        void backpressure(Connection* target_connection) override
+        {
+            utils::invoke(on_backpressure_cb, target_connection->remote_id());
+        }
+
+        void drain(Connection* target_connection) override
+        {
+            utils::invoke(on_drain_cb, target_connection->remote_id());
+        }
+
+        void message(ID id, const void* data, std::uint64_t size) override
+        {
+            utils::invoke(on_message_cb, id, data, size);
+        }
+
+        void connect()
+        {
+            auto socket = std::make_unique<typename Protocol::socket>(context->strand);
+            auto* socket_ptr = socket.get();
+
+            socket_ptr->async_connect(
+                make_endpoint<Protocol>(options.path),
+                [this, socket = std::move(socket)](const boost::system::error_code& ec)
+                {
+                    if (!ec)
+                    {
+                        connection = std::make_unique<Connection>(
+                            FrameReader(
+                                options.buffer_initial,
+                                options.buffer,
+                                std::chrono::milliseconds(options.buffer_idle_ms)
+                            ),
+                            std::move(*socket),
+                            *this,
+                            outbound
+                        );
+                        utils::invoke(
+                            on_ready_cb,
+                            ID{this, connection.get(), &Connection::to_string_local}
+                        );
+                        connection->run();
+                        return;
+                    }
+                    reconnect();
+                }
+            );
+        }
+
+        void reconnect()
+        {
+            context->reconnection.expires_after(std::chrono::milliseconds(25));
+            context->reconnection.async_wait(
+                [this](const boost::system::error_code& ec)
+                {
+                    if (ec != boost::asio::error::operation_aborted)
+                    {
+                        connect();
+                    }
+                }
+            );
+        }
+
+        void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
+        {
+            on_message_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_ready(std::function<void(ID)> handler) override
+        {
+            on_ready_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_connect(std::function<void(ID)> handler) override
+        {
+            on_connect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_disconnect(std::function<void(ID)> handler) override
+        {
+            on_disconnect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options)
+    {
+        if (options.seqpacket)
+        {
+            return std::make_unique<Impl<SeqPacket>>(std::move(options));
+        }
+        return std::make_unique<Impl<Stream>>(std::move(options));
+    }
+}
@@ -0,0 +1,321 @@
+#include <nil/service/uds/server/create.hpp>
+
+#include "../../Pieces.hpp"
+#include "../../Registry.hpp"
+#include "../../tcp/Connection.hpp"
+#include "../../utils.hpp"
+#include "../Protocol.hpp"
+
+#include <boost/asio/basic_socket_acceptor.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <chrono>
+#include <memory>
+#include <unordered_set>
+
+namespace nil::service::uds::server
+{
+    template <typename Protocol>
+    struct Context
+    {
+        explicit Context(const Options& options)
+            : strand(make_strand(ctx))
+            , acceptor(strand)
+        {
+            const auto endpoint = make_endpoint<Protocol>(options.path);
+            // a socket file left behind by a previous server would fail the bind
+            remove_stale(options.path, endpoint.protocol().type());
+            acceptor.open(endpoint.protocol());
+            acceptor.bind(endpoint);
+            file = std::make_unique<SocketFile>(options.path);
+            acceptor.listen();
+        }
+
+        boost::asio::io_context ctx;
+        boost::asio::strand<boost::asio::io_context::executor_type> strand;
+        boost::asio::basic_socket_acceptor<Protocol> acceptor;
+        std::unique_ptr<SocketFile> file;
+        // declared after ctx so that the sockets are closed before it is destroyed
+        Registry<tcp::BasicConnection<Protocol>> connections;
+    };
+
+    template <typename Protocol>
+    struct Impl final
+        : IStandaloneService
+        , ConnectedImpl<tcp::BasicConnection<Protocol>>
+    {
+        using Connection = tcp::BasicConnection<Protocol>;
+
+        static std::string to_string_local(const void* c)
+        {
+            return static_cast<const Impl*>(c)->options.path;
+        }
+
+    public:
+        explicit Impl(Options init_options)
+            : options(std::move(init_options))
+            , outbound(options.backpressure)
+            , context(std::make_unique<Context<Protocol>>(options))
+        {
+            boost::asio::post(
+                context->ctx,
+                [this]() { utils::invoke(on_ready_cb, ID{this, this, Impl::to_string_local}); }
+            );
+            accept();
+        }
+
+        ~Impl() override = default;
+
+        Impl(Impl&&) noexcept = delete;
+        Impl& operator=(Impl&&) noexcept = delete;
+        Impl(const Impl&) = delete;
+        Impl& operator=(const Impl&) = delete;
+
+        void run() override
+        {
+            auto _ = boost::asio::make_work_guard(context->ctx);
+            context->ctx.run();
+        }
+
+        void poll() override
+        {
+            context->ctx.poll();
+        }
+
+        void stop() override
+        {
+            outbound.release(true);
+            context->ctx.stop();
+        }
+
+        void restart() override
+        {
+            outbound.release(false);
+            context.reset();
+            context = std::make_unique<Context<Protocol>>(options);
+            boost::asio::post(
+                context->ctx,
+                [this]() { utils::invoke(on_ready_cb, ID{this, this, Impl::to_string_local}); }
+            );
+            accept();
+        }
+
+        void dispatch(std::function<void()> task) override
+        {
+            boost::asio::dispatch(context->ctx, std::move(task));
+        }
+
+        void publish(Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), msg = std::move(data)]()
+                {
+                    for (const auto& connection : context->connections)
+                    {
+                        connection->write(msg);
+                    }
+                }
+            );
+        }
+
+        void publish_ex(std::vector<ID> ids, Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
+                {
+                    std::unordered_set<const void*> excluded;
+                    for (const auto& id : ids)
+                    {
+                        if (id.owner == this->self())
+                        {
+                            excluded.emplace(id.id);
+                        }
+                    }
+
+                    for (const auto& connection : context->connections)
+                    {
+                        if (!excluded.contains(connection.get()))
+                        {
+                            connection->write(msg);
+                        }
+                    }
+                }
+            );
+        }
+
+        void send(std::vector<ID> ids, Payload data) override
+        {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
+                {
+                    for (const auto& id : ids)
+                    {
+                        if (id.owner != this->self())
+                        {
+                            continue;
+                        }
+
+                        if (auto* connection = context->connections.find(id.id))
+                        {
+                            connection->write(msg);
+                        }
+                    }
+                }
+            );
+        }
+
+        void publish_some(Payload piece, bool last) override
+        {
+            pieces.publish_some(*this, std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            pieces.send_some(*this, std::move(ids), std::move(piece), last);
+        }
+
+    private:
+        Options options;
+        Pieces pieces;
+        Outbound outbound;
+        std::unique_ptr<Context<Protocol>> context;
+
+        std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID)>> on_ready_cb;
+        std::vector<std::function<void(ID)>> on_connect_cb;
+        std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
+
+        // connections identify their owner through the ConnectedImpl base
+        [[nodiscard]] const void* self() const
+        {
+            return static_cast<const ConnectedImpl<Connection>*>(this);
+        }
+
+        [[nodiscard]] bool in_service_thread() const
+        {
+            return context->ctx.get_executor().running_in_this_thread();
+        }
+
+        void connect(Connection* connection) override
+        {
+            utils::invoke(on_connect_cb, connection->remote_id());
+        }
+
+        void disconnect(Connection* connection) override
+        {
+            boost::asio::post(
+                context->strand,
+                [this, id = connection->remote_id()]()
+                {
+                    utils::invoke(on_disconnect_cb, id);
+                    context->connections.remove(id.id);
+                }
+            );
+        }
+
+        void backpressure(Connection* connection) override
+        {
+            utils::invoke(on_backpressure_cb, connection->remote_id());
+        }
+
+        void drain(Connection* connection) override
+        {
+            utils::invoke(on_drain_cb, connection->remote_id());
+        }
+
+        void message(ID id, const void* data, std::uint64_t size) override
+        {
+            utils::invoke(on_message_cb, id, data, size);
+        }
+
+        void accept()
+        {
+            context->acceptor.async_accept(
+                context->strand,
+                [this](const boost::system::error_code& ec, typename Protocol::socket socket)
+                {
+                    if (!ec)
+                    {
+                        auto connection = std::make_unique<Connection>(
+                            FrameReader(
+                                options.buffer_initial,
+                                options.buffer,
+                                std::chrono::milliseconds(options.buffer_idle_ms)
+                            ),
+                            std::move(socket),
+                            *this,
+                            outbound
+                        );
+                        connection->run();
+                        context->connections.add(std::move(connection));
+                    }
+                    accept();
+                }
+            );
+        }
+
+        void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
+        {
+            on_message_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_ready(std::function<void(ID)> handler) override
+        {
+            on_ready_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_connect(std::function<void(ID)> handler) override
+        {
+            on_connect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_disconnect(std::function<void(ID)> handler) override
+        {
+            on_disconnect_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
+    };
+
+    std::unique_ptr<IStandaloneService> create(Options options)
+    {
+        if (options.seqpacket)
+        {
+            return std::make_unique<Impl<SeqPacket>>(std::move(options));
+        }
+        return std::make_unique<Impl<Stream>>(std::move(options));
+    }
+}
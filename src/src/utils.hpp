@@ -4,11 +4,17 @@
 
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ip/udp.hpp>
+#include <boost/asio/generic/basic_endpoint.hpp>
+#include <boost/asio/local/basic_endpoint.hpp>
 
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
 
 namespace nil::service::utils
 {
@@ -34,6 +40,49 @@ namespace nil::service::utils
         return {endpoint.address().to_string() + ":" + std::to_string(endpoint.port())};
     }
 
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    template <typename Protocol>
+    std::string to_id(const boost::asio::local::basic_endpoint<Protocol>& endpoint)
+    {
+        // the clients of a server are usually not bound to a path
+        auto path = endpoint.path();
+        return path.empty() ? std::string("unnamed") : path;
+    }
+
+    template <typename Protocol>
+    std::string to_id(const boost::asio::generic::basic_endpoint<Protocol>& endpoint)
+    {
+        // only used for unix sockets
+        boost::asio::local::basic_endpoint<Protocol> local;
+        const auto size = std::min<std::size_t>(endpoint.size(), local.capacity());
+        std::memcpy(local.data(), endpoint.data(), size);
+        local.resize(size);
+        return to_id(local);
+    }
+#endif
+
+    struct EndpointHash final
+    {
+        template <typename Endpoint>
+        std::size_t operator()(const Endpoint& endpoint) const noexcept
+        {
+            const auto& address = endpoint.address();
+            auto hash = std::size_t(endpoint.port());
+            if (address.is_v4())
+            {
+                hash ^= std::size_t(address.to_v4().to_uint()) << 16u;
+            }
+            else
+            {
+                const auto bytes = address.to_v6().to_bytes();
+                hash ^= std::hash<std::string_view>()(
+                    {reinterpret_cast<const char*>(bytes.data()), bytes.size()}
+                );
+            }
+            return hash;
+        }
+    };
+
     // in tcp, we need to know the size of the actual message
     // to know until when to stop
     constexpr auto TCP_HEADER_SIZE = sizeof(std::uint64_t);
@@ -41,9 +90,68 @@ namespace nil::service::utils
     // in udp, there is no connection guarantee.
     constexpr std::uint8_t UDP_INTERNAL_MESSAGE = 1u;
     constexpr std::uint8_t UDP_EXTERNAL_MESSAGE = 0u;
+    constexpr std::uint8_t UDP_FRAGMENT_MESSAGE = 2u;
+    constexpr std::uint8_t UDP_RELIABLE_MESSAGE = 3u;
+    constexpr std::uint8_t UDP_ACK_MESSAGE = 4u;
 
     constexpr auto PROBE_INTERVAL_MS = 25;
 
+    // SO_REUSEPORT lets several sockets bind the same address.
+    // the kernel then balances accepts / datagrams between them.
+#ifdef SO_REUSEPORT
+    constexpr auto HAS_REUSE_PORT = true;
+
+    /**
+     * @brief SO_REUSEPORT as a settable socket option of asio.
+     */
+    struct ReusePort final
+    {
+        int value = 1;
+
+        template <typename Protocol>
+        int level(const Protocol& /* protocol */) const
+        {
+            return SOL_SOCKET;
+        }
+
+        template <typename Protocol>
+        int name(const Protocol& /* protocol */) const
+        {
+            return SO_REUSEPORT;
+        }
+
+        template <typename Protocol>
+        const int* data(const Protocol& /* protocol */) const
+        {
+            return &value;
+        }
+
+        template <typename Protocol>
+        std::size_t size(const Protocol& /* protocol */) const
+        {
+            return sizeof(value);
+        }
+    };
+#else
+    constexpr auto HAS_REUSE_PORT = false;
+#endif
+
+    template <typename Socket>
+    void bind(Socket& socket, const typename Socket::endpoint_type& endpoint, bool share_port)
+    {
+        socket.open(endpoint.protocol());
+        socket.set_option(boost::asio::socket_base::reuse_address(true));
+#ifdef SO_REUSEPORT
+        if (share_port)
+        {
+            socket.set_option(ReusePort{});
+        }
+#else
+        (void)share_port;
+#endif
+        socket.bind(endpoint);
+    }
+
     constexpr auto TO_BITS = 8u;
     constexpr auto START_INDEX = 0u;
 
@@ -1,23 +1,93 @@
 #include "Connection.hpp"
 #include "../utils.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
 namespace nil::service::ws
 {
+    namespace
+    {
+        // upper bound of frames coalesced into one gather write
+        constexpr auto MAX_GATHER_FRAMES = 64u;
+
+        // live connections, for `ws::stats` called from other threads
+        struct Live final
+        {
+            std::mutex mutex;
+            std::unordered_set<const void*> connections;
+        };
+
+        Live& live()
+        {
+            // never destroyed: services can outlive the statics
+            static auto* instance = new Live(); // NOLINT
+            return *instance;
+        }
+    }
+
+    std::optional<Stats> stats(const ID& id)
+    {
+        if (id.to_string != &Connection::to_string_remote)
+        {
+            return std::nullopt;
+        }
+        return Connection::stats(id.id);
+    }
+
     Connection::Connection(
         std::uint64_t init_buffer,
-        boost::beast::websocket::stream<boost::beast::tcp_stream> init_ws,
-        ConnectedImpl<Connection>& init_impl
+        Stream init_ws,
+        ConnectedImpl<Connection>& init_impl,
+        Outbound& init_outbound,
+        std::uint64_t init_frame_below,
+        bool init_compressed,
+        bool init_stream
     )
         : ws(std::move(init_ws))
-        , local_endpoint(ws.next_layer().socket().local_endpoint())
-        , remote_endpoint(ws.next_layer().socket().remote_endpoint())
+        , local_endpoint(boost::beast::get_lowest_layer(ws).socket().local_endpoint())
+        , remote_endpoint(boost::beast::get_lowest_layer(ws).socket().remote_endpoint())
         , flat_buffer(init_buffer)
         , impl(init_impl)
+        , stream(init_stream)
+        , frame_below(init_frame_below)
+        , compressed(init_compressed)
+        , gate(ws.next_layer().gate())
+        , outbound(init_outbound)
+        , alive(std::make_shared<bool>(true))
     {
         ws.binary(true);
+        if (stream)
+        {
+            // only the pieces are bounded by the buffer
+            ws.read_message_max(0);
+        }
+        // cleared by the destructor
+        gate->resume = [this]() { resume(); };
+
+        auto& l = live();
+        const std::lock_guard _(l.mutex);
+        l.connections.emplace(this);
     }
 
-    Connection::~Connection() noexcept = default;
+    Connection::~Connection() noexcept
+    {
+        {
+            auto& l = live();
+            const std::lock_guard _(l.mutex);
+            l.connections.erase(this);
+        }
+        *alive = false;
+        gate->resume = nullptr;
+        outbound.remove(w_bytes);
+        if (stalled)
+        {
+            outbound.stall(false);
+        }
+    }
 
     void Connection::run()
     {
@@ -27,27 +97,309 @@ namespace nil::service::ws
 
     void Connection::read()
     {
-        ws.async_read(
-            flat_buffer,
-            [this](boost::beast::error_code ec, std::size_t count)
+        auto on_read = [this](boost::beast::error_code ec, std::size_t count)
+        {
+            if (ec)
             {
-                if (ec)
-                {
-                    impl.disconnect(this);
-                    return;
-                }
+                impl.disconnect(this);
+                return;
+            }
 
-                impl.message(remote_id(), flat_buffer.cdata().data(), count);
-                flat_buffer.consume(count);
+            FrameStream::count_bytes(received_bytes, count);
+            const auto size = flat_buffer.size();
+            const auto done = ws.is_message_done();
+            if (!done && size < flat_buffer.max_size())
+            {
+                // pieces fill the buffer before they are delivered
                 read();
+                return;
             }
-        );
+
+            if (stream)
+            {
+                const auto position = Piece{.first = r_first, .last = done};
+                r_first = done;
+                impl.piece(remote_id(), flat_buffer.cdata().data(), size, position);
+            }
+            else
+            {
+                impl.message(remote_id(), flat_buffer.cdata().data(), size);
+            }
+            flat_buffer.consume(size);
+            read();
+        };
+
+        if (stream)
+        {
+            const auto limit = flat_buffer.max_size() - flat_buffer.size();
+            ws.async_read_some(flat_buffer, limit, std::move(on_read));
+        }
+        else
+        {
+            ws.async_read(flat_buffer, std::move(on_read));
+        }
     }
 
-    void Connection::write(const std::uint8_t* data, std::uint64_t size)
+    void Connection::write(Payload payload)
     {
-        boost::system::error_code ec;
-        ws.write(boost::asio::buffer(data, size), ec);
+        auto header = payload.size() < frame_below ? frame_header(payload.size()) : Payload();
+        write(std::move(header), std::move(payload));
+    }
+
+    void Connection::write(Payload header, Payload payload)
+    {
+        if (!ws.is_open())
+        {
+            return;
+        }
+
+        const auto size = payload.size();
+        if (size >= frame_below)
+        {
+            // compressed (or masked) by beast
+            header = {};
+        }
+
+        if (exceeds(size))
+        {
+            raise_backpressure();
+            switch (outbound.limits().policy)
+            {
+                case Backpressure::Policy::drop_newest:
+                    return;
+                case Backpressure::Policy::drop_oldest:
+                    drop_oldest(size);
+                    break;
+                case Backpressure::Policy::disconnect:
+                    close();
+                    return;
+                case Backpressure::Policy::block:
+                    // callers are held back by Outbound until the backlog drains
+                    break;
+            }
+        }
+
+        // a message can not start before the open one completes
+        auto& queue = w_open ? w_held : w_queue;
+        queue.push_back({.header = std::move(header), .body = std::move(payload)});
+        account_added(size);
+        resume();
+    }
+
+    void Connection::write_some(Payload piece, bool first, bool last)
+    {
+        if (!ws.is_open() || (!w_open && !first))
+        {
+            return;
+        }
+
+        const auto size = piece.size();
+        if (exceeds(size))
+        {
+            // dropping a piece would corrupt its message, it is queued anyway
+            raise_backpressure();
+            switch (outbound.limits().policy)
+            {
+                case Backpressure::Policy::drop_oldest:
+                    drop_oldest(size);
+                    break;
+                case Backpressure::Policy::disconnect:
+                    close();
+                    return;
+                case Backpressure::Policy::drop_newest:
+                case Backpressure::Policy::block:
+                    break;
+            }
+        }
+
+        w_queue.push_back({.header = {}, .body = std::move(piece), .piece = true, .last = last});
+        account_added(size);
+        w_open = !last;
+        if (last)
+        {
+            std::move(w_held.begin(), w_held.end(), std::back_inserter(w_queue));
+            w_held.clear();
+        }
+        resume();
+    }
+
+    void Connection::resume()
+    {
+        // frames wait for the writes of beast (pong, close) to complete
+        if (w_flight.empty() && !w_queue.empty() && !gate->control)
+        {
+            flush();
+        }
+    }
+
+    bool Connection::exceeds(std::uint64_t size) const
+    {
+        return exceeds_own(size) || outbound.exceeds(size);
+    }
+
+    bool Connection::exceeds_own(std::uint64_t size) const
+    {
+        const auto& limits = outbound.limits();
+        const auto messages = w_queue.size() + w_held.size() + w_flight.size();
+        return (limits.max_bytes != 0 && w_bytes + size > limits.max_bytes)
+            || (limits.max_messages != 0 && messages >= limits.max_messages);
+    }
+
+    void Connection::drop_oldest(std::uint64_t size)
+    {
+        // pieces are kept, dropping one would corrupt its message
+        auto it = w_queue.begin();
+        while (it != w_queue.end() && exceeds(size))
+        {
+            if (it->piece)
+            {
+                ++it;
+                continue;
+            }
+            account_removed(it->body.size());
+            it = w_queue.erase(it);
+        }
+    }
+
+    void Connection::account_added(std::uint64_t size)
+    {
+        w_bytes += size;
+        outbound.add(size);
+
+        const auto& limits = outbound.limits();
+        if (!stalled && limits.policy == Backpressure::Policy::block && exceeds_own(0))
+        {
+            stalled = true;
+            outbound.stall(true);
+        }
+
+        if (high_water() != 0 && w_bytes >= high_water())
+        {
+            raise_backpressure();
+        }
+    }
+
+    std::uint64_t Connection::high_water() const
+    {
+        const auto& limits = outbound.limits();
+        return limits.high_water != 0 ? limits.high_water : limits.max_bytes;
+    }
+
+    void Connection::raise_backpressure()
+    {
+        if (!congested)
+        {
+            congested = true;
+            impl.backpressure(this);
+        }
+    }
+
+    void Connection::account_removed(std::uint64_t size)
+    {
+        w_bytes -= size;
+        outbound.remove(size);
+
+        if (stalled && !exceeds_own(0))
+        {
+            stalled = false;
+            outbound.stall(false);
+        }
+
+        if (congested && w_bytes <= high_water() / 2)
+        {
+            congested = false;
+            impl.drain(this);
+        }
+    }
+
+    void Connection::close()
+    {
+        // reader will observe the closed socket and report the disconnect
+        congested = false;
+        account_removed(w_bytes - w_flight_bytes);
+        w_queue.clear();
+        w_held.clear();
+        w_open = false;
+        boost::system::error_code ignored;
+        boost::beast::get_lowest_layer(ws).socket().close(ignored);
+    }
+
+    void Connection::flush()
+    {
+        // beast writes a message (or a piece) per call, frames are coalesced into one gather write
+        const auto framed = !w_queue.front().header.empty();
+        while (!w_queue.empty() && w_flight.size() < (framed ? MAX_GATHER_FRAMES : 1)
+               && !w_queue.front().header.empty() == framed)
+        {
+            w_flight_bytes += w_queue.front().body.size();
+            w_flight.push_back(std::move(w_queue.front()));
+            w_queue.pop_front();
+        }
+
+        auto on_written = [this, alive = alive](const boost::system::error_code& ec, std::size_t)
+        {
+            if (!*alive)
+            {
+                return;
+            }
+
+            if (gate->framing)
+            {
+                gate->framing = false;
+                if (auto deferred = std::move(gate->deferred))
+                {
+                    deferred->run();
+                }
+            }
+
+            w_flight.clear();
+            FrameStream::count_bytes(sent_bytes, w_flight_bytes);
+            account_removed(std::exchange(w_flight_bytes, 0));
+            if (ec)
+            {
+                close();
+                return;
+            }
+
+            resume();
+        };
+
+        if (!framed)
+        {
+            const auto& frame = w_flight.front();
+            const auto buffer = boost::asio::buffer(frame.body.data(), frame.body.size());
+            if (frame.piece)
+            {
+                ws.async_write_some(frame.last, buffer, std::move(on_written));
+            }
+            else
+            {
+                ws.async_write(buffer, std::move(on_written));
+            }
+            return;
+        }
+
+        w_buffers.clear();
+        for (const auto& frame : w_flight)
+        {
+            w_buffers.emplace_back(boost::asio::buffer(frame.header.data(), frame.header.size()));
+            if (!frame.body.empty())
+            {
+                const auto& body = frame.body;
+                w_buffers.emplace_back(boost::asio::buffer(body.data(), body.size()));
+            }
+        }
+        gate->framing = true;
+        boost::asio::async_write(
+            ws.next_layer().next_layer(),
+            w_buffers,
+            [gate = gate, on_written = std::move(on_written)] //
+            (const boost::system::error_code& ec, std::size_t count) mutable
+            {
+                FrameStream::count_bytes(gate->written_bytes, count);
+                on_written(ec, count);
+            }
+        );
     }
 
     std::string Connection::to_string_local(const void* c)
@@ -64,4 +416,23 @@ namespace nil::service::ws
     {
         return ID{&impl, this, &to_string_remote};
     }
+
+    std::optional<Stats> Connection::stats(const void* c)
+    {
+        auto& l = live();
+        const std::lock_guard _(l.mutex);
+        if (!l.connections.contains(c))
+        {
+            return std::nullopt;
+        }
+
+        const auto* connection = static_cast<const Connection*>(c);
+        return Stats{
+            .compressed = connection->compressed,
+            .sent_bytes = connection->sent_bytes.load(std::memory_order_relaxed),
+            .sent_wire_bytes = connection->gate->written_bytes.load(std::memory_order_relaxed),
+            .received_bytes = connection->received_bytes.load(std::memory_order_relaxed),
+            .received_wire_bytes = connection->gate->read_bytes.load(std::memory_order_relaxed)
+        };
+    }
 }
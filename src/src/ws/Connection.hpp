@@ -1,21 +1,42 @@
 #pragma once
 
 #include "../ConnectedImpl.hpp"
+#include "../Outbound.hpp"
+#include "FrameStream.hpp"
 
 #include <nil/service/ID.hpp>
+#include <nil/service/payload.hpp>
+#include <nil/service/ws/compression.hpp>
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
 
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
 namespace nil::service::ws
 {
     class Connection final
     {
     public:
+        /**
+         * @param init_frame_below  messages smaller than this are framed by the connection
+         *                          (see `FrameStream`), uncompressed. larger ones by beast.
+         *                          0 for clients, their frames are masked.
+         * @param init_compressed   permessage-deflate was negotiated
+         * @param init_stream       deliver the messages in pieces as they arrive
+         */
         Connection(
             std::uint64_t init_buffer,
-            boost::beast::websocket::stream<boost::beast::tcp_stream> init_ws,
-            ConnectedImpl<Connection>& init_impl
+            Stream init_ws,
+            ConnectedImpl<Connection>& init_impl,
+            Outbound& init_outbound,
+            std::uint64_t init_frame_below,
+            bool init_compressed,
+            bool init_stream
         );
         ~Connection() noexcept;
 
@@ -26,19 +47,91 @@ namespace nil::service::ws
         Connection& operator=(const Connection&) = delete;
 
         void run();
-        void write(const std::uint8_t* data, std::uint64_t size);
+        /**
+         * @brief queue a message for writing. non-blocking.
+         *  queued frames are coalesced into a single gather write,
+         *  beast writes the other messages one at a time.
+         */
+        void write(Payload payload);
+        /**
+         * @brief queue a message framed by `header` (see `frame_header`).
+         *  a broadcast builds the header once and shares it with every connection.
+         *  the header is ignored if beast frames the message.
+         */
+        void write(Payload header, Payload payload);
+        /**
+         * @brief queue a piece of a message, written as a frame by beast. non-blocking.
+         *  whole messages are held back until the `last` piece is queued.
+         *  pieces are never dropped by the backpressure policies.
+         * @param first     the piece may start a message. when false, the piece is skipped
+         *                  if no message is open (connections joining a broadcast midway).
+         */
+        void write_some(Payload piece, bool first, bool last);
         ID remote_id() const;
 
+        /**
+         * @brief counters of the live connection at `c`, nullopt otherwise.
+         *  connections register themselves while alive: can be called from any thread.
+         */
+        static std::optional<Stats> stats(const void* c);
+
         static std::string to_string_local(const void* c);
         static std::string to_string_remote(const void* c);
 
     private:
         void read();
+        void resume();
+        void flush();
+        void close();
+        [[nodiscard]] bool exceeds(std::uint64_t size) const;
+        [[nodiscard]] bool exceeds_own(std::uint64_t size) const;
+        void drop_oldest(std::uint64_t size);
+        void account_added(std::uint64_t size);
+        void account_removed(std::uint64_t size);
+        [[nodiscard]] std::uint64_t high_water() const;
+        void raise_backpressure();
 
-        boost::beast::websocket::stream<boost::beast::tcp_stream> ws;
+        struct Frame final
+        {
+            // empty when beast frames the message
+            Payload header;
+            Payload body;
+            // part of a message written with write_some
+            bool piece = false;
+            bool last = true;
+        };
+
+        Stream ws;
         boost::asio::ip::tcp::endpoint local_endpoint;
         boost::asio::ip::tcp::endpoint remote_endpoint;
         boost::beast::flat_buffer flat_buffer;
         ConnectedImpl<Connection>& impl;
+        bool stream;
+        // the next piece read starts a message
+        bool r_first = true;
+
+        std::uint64_t frame_below;
+        bool compressed;
+        std::shared_ptr<FrameStream::Gate> gate;
+        // message bytes. updated by the service thread, read by `stats()`
+        std::atomic<std::uint64_t> sent_bytes = 0;
+        std::atomic<std::uint64_t> received_bytes = 0;
+        Outbound& outbound;
+        // messages waiting to be written
+        std::deque<Frame> w_queue;
+        // whole messages waiting for the open message to complete
+        std::deque<Frame> w_held;
+        // the last piece of a message is not queued yet
+        bool w_open = false;
+        // messages of the in-flight write
+        std::vector<Frame> w_flight;
+        std::vector<boost::asio::const_buffer> w_buffers;
+        // bytes of both waiting and in-flight messages
+        std::uint64_t w_bytes = 0;
+        std::uint64_t w_flight_bytes = 0;
+        bool congested = false;
+        bool stalled = false;
+        // pending write handlers may outlive the connection.
+        std::shared_ptr<bool> alive;
     };
 }
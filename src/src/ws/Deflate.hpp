@@ -0,0 +1,40 @@
+#pragma once
+
+#include <nil/service/ws/compression.hpp>
+
+#include <boost/beast/websocket.hpp>
+
+#include <string_view>
+
+namespace nil::service::ws
+{
+    inline boost::beast::websocket::permessage_deflate deflate_option(
+        const Compression& compression,
+        boost::beast::role_type role
+    )
+    {
+        boost::beast::websocket::permessage_deflate option;
+        option.server_enable = compression.enabled && role == boost::beast::role_type::server;
+        option.client_enable = compression.enabled && role == boost::beast::role_type::client;
+        option.server_max_window_bits = compression.window_bits;
+        option.client_max_window_bits = compression.window_bits;
+        option.server_no_context_takeover = !compression.context_takeover;
+        option.client_no_context_takeover = !compression.context_takeover;
+        option.compLevel = compression.level;
+        option.memLevel = compression.mem_level;
+        return option;
+    }
+
+    /**
+     * @brief true if the extension is offered by the upgrade request (server side)
+     *  or accepted by the upgrade response (client side).
+     */
+    template <typename Fields>
+    bool negotiates_deflate(const Compression& compression, const Fields& fields)
+    {
+        const auto extensions = fields[boost::beast::http::field::sec_websocket_extensions];
+        return compression.enabled
+            && std::string_view(extensions.data(), extensions.size()).find("permessage-deflate")
+            != std::string_view::npos;
+    }
+}
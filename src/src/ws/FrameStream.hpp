@@ -0,0 +1,212 @@
+#pragma once
+
+#include <nil/service/payload.hpp>
+
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace nil::service::ws
+{
+    /**
+     * @brief header of an unmasked, unfragmented binary frame of `size` bytes.
+     *  server frames are not masked, the same header is valid for every connection.
+     */
+    inline Payload frame_header(std::uint64_t size)
+    {
+        constexpr std::uint8_t FIN_BINARY = 0x82;
+        const auto extra = size < 126 ? 0u : size <= 0xFFFF ? 2u : 8u;
+        return Payload::create(
+            2 + extra,
+            [size, extra](std::uint8_t* bytes)
+            {
+                bytes[0] = FIN_BINARY;
+                bytes[1] = extra == 0 ? std::uint8_t(size) : extra == 2 ? 126 : 127;
+                for (auto i = 0u; i < extra; ++i)
+                {
+                    bytes[2 + i] = std::uint8_t(size >> (8 * (extra - 1 - i)));
+                }
+            }
+        );
+    }
+
+    /**
+     * @brief next layer of the websocket streams.
+     *  beast writes its frames (handshake, pong, close) through `async_write_some`,
+     *  a server connection writes its pre-framed messages directly to `next_layer()`
+     *  while `Gate::framing` is set. each side waits for the other to complete so that
+     *  the frames never interleave on the socket.
+     *  not final: asio inspects the type by deriving from it.
+     */
+    class FrameStream
+    {
+    public:
+        struct Task
+        {
+            Task() = default;
+            virtual ~Task() noexcept = default;
+            Task(Task&&) noexcept = delete;
+            Task(const Task&) = delete;
+            Task& operator=(Task&&) noexcept = delete;
+            Task& operator=(const Task&) = delete;
+
+            virtual void run() = 0;
+        };
+
+        struct Gate final
+        {
+            // the connection is writing frames
+            bool framing = false;
+            // a write of beast is not complete yet
+            bool control = false;
+            // write of beast waiting for the frames to be written
+            std::unique_ptr<Task> deferred;
+            // called once a write of beast completes
+            std::function<void()> resume;
+            // bytes on the socket. updated by the service thread, read by `ws::stats`
+            std::atomic<std::uint64_t> read_bytes = 0;
+            std::atomic<std::uint64_t> written_bytes = 0;
+        };
+
+        using executor_type = boost::beast::tcp_stream::executor_type;
+
+        template <typename... Args>
+        explicit FrameStream(Args&&... args)
+            : next(std::forward<Args>(args)...)
+            , shared_gate(std::make_shared<Gate>())
+        {
+        }
+
+        executor_type get_executor() noexcept
+        {
+            return next.get_executor();
+        }
+
+        boost::beast::tcp_stream& next_layer() noexcept
+        {
+            return next;
+        }
+
+        const boost::beast::tcp_stream& next_layer() const noexcept
+        {
+            return next;
+        }
+
+        const std::shared_ptr<Gate>& gate() const noexcept
+        {
+            return shared_gate;
+        }
+
+        template <typename Buffers, typename Handler>
+        void async_read_some(const Buffers& buffers, Handler&& handler)
+        {
+            const auto executor
+                = boost::asio::get_associated_executor(handler, next.get_executor());
+            next.async_read_some(
+                buffers,
+                boost::asio::bind_executor(
+                    executor,
+                    [gate = shared_gate, handler = std::forward<Handler>(handler)] //
+                    (const boost::system::error_code& ec, std::size_t count) mutable
+                    {
+                        count_bytes(gate->read_bytes, count);
+                        handler(ec, count);
+                    }
+                )
+            );
+        }
+
+        // single writer (the service thread), no read-modify-write needed
+        static void count_bytes(std::atomic<std::uint64_t>& counter, std::uint64_t count)
+        {
+            const auto value = counter.load(std::memory_order_relaxed);
+            counter.store(value + count, std::memory_order_relaxed);
+        }
+
+        template <typename Buffers, typename Handler>
+        void async_write_some(const Buffers& buffers, Handler&& handler)
+        {
+            if (shared_gate->framing)
+            {
+                // beast serializes its writes, only one can wait
+                using task_type = Deferred<Buffers, std::decay_t<Handler>>;
+                shared_gate->deferred
+                    = std::make_unique<task_type>(*this, buffers, std::forward<Handler>(handler));
+                return;
+            }
+
+            shared_gate->control = true;
+            const auto executor
+                = boost::asio::get_associated_executor(handler, next.get_executor());
+            next.async_write_some(
+                buffers,
+                boost::asio::bind_executor(
+                    executor,
+                    [gate = shared_gate,
+                     size = boost::asio::buffer_size(buffers),
+                     handler = std::forward<Handler>(handler)] //
+                    (const boost::system::error_code& ec, std::size_t count) mutable
+                    {
+                        // a partial write is continued by beast before anything else
+                        gate->control = !ec && count < size;
+                        count_bytes(gate->written_bytes, count);
+                        handler(ec, count);
+                        if (!gate->control && gate->resume)
+                        {
+                            gate->resume();
+                        }
+                    }
+                )
+            );
+        }
+
+    private:
+        template <typename Buffers, typename Handler>
+        struct Deferred final: Task
+        {
+            Deferred(FrameStream& init_stream, Buffers init_buffers, Handler init_handler)
+                : stream(init_stream)
+                , buffers(std::move(init_buffers))
+                , handler(std::move(init_handler))
+            {
+            }
+
+            void run() override
+            {
+                stream.async_write_some(buffers, std::move(handler));
+            }
+
+            FrameStream& stream;
+            Buffers buffers;
+            Handler handler;
+        };
+
+        boost::beast::tcp_stream next;
+        std::shared_ptr<Gate> shared_gate;
+    };
+
+    inline void teardown(
+        boost::beast::role_type role,
+        FrameStream& stream,
+        boost::system::error_code& ec
+    )
+    {
+        using boost::beast::websocket::teardown;
+        teardown(role, stream.next_layer(), ec);
+    }
+
+    template <typename Handler>
+    void async_teardown(boost::beast::role_type role, FrameStream& stream, Handler&& handler)
+    {
+        using boost::beast::websocket::async_teardown;
+        async_teardown(role, stream.next_layer(), std::forward<Handler>(handler));
+    }
+
+    using Stream = boost::beast::websocket::stream<FrameStream>;
+}
@@ -2,6 +2,7 @@
 
 #include "../../utils.hpp"
 #include "../Connection.hpp"
+#include "../Deflate.hpp"
 
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
@@ -9,6 +10,7 @@
 #include <boost/asio/strand.hpp>
 
 #include <algorithm>
+#include <utility>
 
 namespace nil::service::ws::client
 {
@@ -37,6 +39,7 @@ namespace nil::service::ws::client
     public:
         explicit Impl(Options init_options)
             : options(std::move(init_options))
+            , outbound(options.backpressure)
             , context(std::make_unique<Context>())
         {
             connect();
@@ -62,11 +65,13 @@ namespace nil::service::ws::client
 
         void stop() override
         {
+            outbound.release(true);
             context->ctx.stop();
         }
 
         void restart() override
         {
+            outbound.release(false);
             context = std::make_unique<Context>();
             connect();
         }
@@ -76,19 +81,32 @@ namespace nil::service::ws::client
             boost::asio::dispatch(context->ctx, std::move(task));
         }
 
-        void publish(std::vector<std::uint8_t> data) override
+        void publish(Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, msg = std::move(data)]() { write_if_connected(msg); }
+                [this, ticket = std::move(*ticket), msg = std::move(data)]()
+                { write_if_connected(msg); }
             );
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void publish_ex(std::vector<ID> ids, Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
                 {
                     if (!has_remote_id(ids))
                     {
@@ -98,11 +116,17 @@ namespace nil::service::ws::client
             );
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> data) override
+        void send(std::vector<ID> ids, Payload data) override
         {
+            auto ticket = outbound.admit(data.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
             boost::asio::post(
                 context->strand,
-                [this, ids = std::move(ids), msg = std::move(data)]()
+                [this, ticket = std::move(*ticket), ids = std::move(ids), msg = std::move(data)]()
                 {
                     if (has_remote_id(ids))
                     {
@@ -112,15 +136,65 @@ namespace nil::service::ws::client
             );
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            auto ticket = outbound.admit(piece.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this, ticket = std::move(*ticket), msg = std::move(piece), last]()
+                { write_some_if_connected(msg, last); }
+            );
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            auto ticket = outbound.admit(piece.size(), in_service_thread());
+            if (!ticket)
+            {
+                return;
+            }
+
+            boost::asio::post(
+                context->strand,
+                [this,
+                 ticket = std::move(*ticket),
+                 ids = std::move(ids),
+                 msg = std::move(piece),
+                 last]()
+                {
+                    if (has_remote_id(ids))
+                    {
+                        write_some_if_connected(msg, last);
+                    }
+                }
+            );
+        }
+
     private:
         Options options;
+        Outbound outbound;
         std::unique_ptr<Context> context;
         std::unique_ptr<Connection> connection;
+        // a message of publish_some / send_some is open (service thread)
+        bool publishing = false;
 
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID, const void*, std::uint64_t, Piece)>> on_piece_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
+
+        [[nodiscard]] bool in_service_thread() const
+        {
+            return context->ctx.get_executor().running_in_this_thread();
+        }
 
         [[nodiscard]] bool has_remote_id(const std::vector<ID>& ids) const
         {
@@ -131,11 +205,21 @@ namespace nil::service::ws::client
             return ids.end() != std::find(ids.begin(), ids.end(), connection->remote_id());
         }
 
-        void write_if_connected(const std::vector<std::uint8_t>& msg)
+        void write_if_connected(const Payload& msg)
         {
             if (connection != nullptr)
             {
-                connection->write(msg.data(), msg.size());
+                connection->write(msg);
+            }
+        }
+
+        void write_some_if_connected(const Payload& msg, bool last)
+        {
+            // a reconnected connection skips the rest of the open message
+            const auto first = !std::exchange(publishing, !last);
+            if (connection != nullptr)
+            {
+                connection->write_some(msg, first, last);
             }
         }
 
@@ -160,9 +244,25 @@ namespace nil::service::ws::client
             );
         }
 
+        void backpressure(Connection* target_connection) override
+        {
+            utils::invoke(on_backpressure_cb, target_connection->remote_id());
+        }
+
+        void drain(Connection* target_connection) override
+        {
+            utils::invoke(on_drain_cb, target_connection->remote_id());
+        }
+
         void message(ID id, const void* data, std::uint64_t size) override
         {
             utils::invoke(on_message_cb, id, data, size);
+            utils::invoke(on_piece_cb, id, data, size, Piece{});
+        }
+
+        void piece(ID id, const void* data, std::uint64_t size, Piece position) override
+        {
+            utils::invoke(on_piece_cb, id, data, size, position);
         }
 
         void connect()
@@ -178,12 +278,13 @@ namespace nil::service::ws::client
                         reconnect();
                         return;
                     }
-                    auto ws = std::make_unique<
-                        boost::beast::websocket::stream<boost::beast::tcp_stream>>(std::move(*socket
-                    ));
+                    auto ws = std::make_unique<Stream>(std::move(*socket));
                     ws->set_option(boost::beast::websocket::stream_base::timeout::suggested(
                         boost::beast::role_type::client
                     ));
+                    ws->set_option(
+                        deflate_option(options.compression, boost::beast::role_type::client)
+                    );
                     ws->set_option(boost::beast::websocket::stream_base::decorator(
                         [](boost::beast::websocket::request_type& req)
                         {
@@ -193,11 +294,16 @@ namespace nil::service::ws::client
                             );
                         }
                     ));
+                    // tells if the server accepted the compression
+                    auto response = std::make_unique<boost::beast::websocket::response_type>();
                     auto* ws_ptr = ws.get();
+                    auto* response_ptr = response.get();
                     ws_ptr->async_handshake(
+                        *response_ptr,
                         options.host + ':' + std::to_string(options.port),
                         options.route,
-                        [this, ws = std::move(ws)](boost::beast::error_code ec)
+                        [this, ws = std::move(ws), response = std::move(response)] //
+                        (boost::beast::error_code ec)
                         {
                             if (ec)
                             {
@@ -208,7 +314,11 @@ namespace nil::service::ws::client
                             connection = std::make_unique<Connection>(
                                 options.buffer,
                                 std::move(*ws),
-                                *this
+                                *this,
+                                outbound,
+                                0,
+                                negotiates_deflate(options.compression, *response),
+                                options.stream
                             );
                             utils::invoke(on_ready_cb, ID{this, this, &Impl::to_string});
                             connection->run();
@@ -237,6 +347,13 @@ namespace nil::service::ws::client
             on_message_cb.push_back(std::move(handler));
         }
 
+        void impl_on_piece(
+            std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+        ) override
+        {
+            on_piece_cb.push_back(std::move(handler));
+        }
+
         void impl_on_ready(std::function<void(ID)> handler) override
         {
             on_ready_cb.push_back(std::move(handler));
@@ -251,6 +368,16 @@ namespace nil::service::ws::client
         {
             on_disconnect_cb.push_back(std::move(handler));
         }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
     };
 
     std::unique_ptr<IStandaloneService> create(Options options)
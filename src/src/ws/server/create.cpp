@@ -9,28 +9,43 @@ namespace nil::service::ws::server
     public:
         explicit Impl(Options options)
             : server(http::server::create(
-                  {.host = std::move(options.host), .port = options.port, .buffer = options.buffer}
+                  {.host = std::move(options.host),
+                   .port = options.port,
+                   .buffer = options.buffer,
+                   .backpressure = options.backpressure,
+                   .compression = options.compression,
+                   .stream = options.stream}
               ))
             , ws(server->use_ws(options.route))
         {
             attach_callbacks();
         }
 
-        void publish(std::vector<std::uint8_t> payload) override
+        void publish(Payload payload) override
         {
             ws->publish(std::move(payload));
         }
 
-        void publish_ex(std::vector<ID> ids, std::vector<std::uint8_t> payload) override
+        void publish_ex(std::vector<ID> ids, Payload payload) override
         {
             ws->publish_ex(std::move(ids), std::move(payload));
         }
 
-        void send(std::vector<ID> ids, std::vector<std::uint8_t> payload) override
+        void send(std::vector<ID> ids, Payload payload) override
         {
             ws->send(std::move(ids), std::move(payload));
         }
 
+        void publish_some(Payload piece, bool last) override
+        {
+            ws->publish_some(std::move(piece), last);
+        }
+
+        void send_some(std::vector<ID> ids, Payload piece, bool last) override
+        {
+            ws->send_some(std::move(ids), std::move(piece), last);
+        }
+
         void run() override
         {
             server->run();
@@ -61,9 +76,12 @@ namespace nil::service::ws::server
         IEventService* ws;
 
         std::vector<std::function<void(ID, const void*, std::uint64_t)>> on_message_cb;
+        std::vector<std::function<void(ID, const void*, std::uint64_t, Piece)>> on_piece_cb;
         std::vector<std::function<void(ID)>> on_ready_cb;
         std::vector<std::function<void(ID)>> on_connect_cb;
         std::vector<std::function<void(ID)>> on_disconnect_cb;
+        std::vector<std::function<void(ID)>> on_backpressure_cb;
+        std::vector<std::function<void(ID)>> on_drain_cb;
 
         void attach_callbacks()
         {
@@ -76,6 +94,15 @@ namespace nil::service::ws::server
                     }
                 }
             );
+            ws->on_piece(
+                [this](ID id, const void* data, std::uint64_t size, Piece position)
+                {
+                    for (const auto& cb : on_piece_cb)
+                    {
+                        cb(id, data, size, position);
+                    }
+                }
+            );
             ws->on_connect(
                 [this](ID id)
                 {
@@ -103,6 +130,24 @@ namespace nil::service::ws::server
                     }
                 }
             );
+            ws->on_backpressure(
+                [this](ID id)
+                {
+                    for (const auto& cb : on_backpressure_cb)
+                    {
+                        cb(id);
+                    }
+                }
+            );
+            ws->on_drain(
+                [this](ID id)
+                {
+                    for (const auto& cb : on_drain_cb)
+                    {
+                        cb(id);
+                    }
+                }
+            );
         }
 
         void impl_on_message(std::function<void(ID, const void*, std::uint64_t)> handler) override
@@ -110,6 +155,13 @@ namespace nil::service::ws::server
             on_message_cb.push_back(std::move(handler));
         }
 
+        void impl_on_piece(
+            std::function<void(ID, const void*, std::uint64_t, Piece)> handler
+        ) override
+        {
+            on_piece_cb.push_back(std::move(handler));
+        }
+
         void impl_on_ready(std::function<void(ID)> handler) override
         {
             on_ready_cb.push_back(std::move(handler));
@@ -124,6 +176,16 @@ namespace nil::service::ws::server
         {
             on_disconnect_cb.push_back(std::move(handler));
         }
+
+        void impl_on_backpressure(std::function<void(ID)> handler) override
+        {
+            on_backpressure_cb.push_back(std::move(handler));
+        }
+
+        void impl_on_drain(std::function<void(ID)> handler) override
+        {
+            on_drain_cb.push_back(std::move(handler));
+        }
     };
 
     std::unique_ptr<IStandaloneService> create(Options options)
@@ -4,6 +4,7 @@
 #include <nil/service/map.hpp>
 #include <nil/service/structs.hpp>
 
+#include "../../src/src/Pieces.hpp"
 #include "../../src/src/utils.hpp"
 
 #include <gmock/gmock.h>
@@ -81,12 +82,12 @@ public:
     {
     }
 
-    void publish(std::vector<std::uint8_t> message) override
+    void publish(nil::service::Payload message) override
     {
         nil::service::utils::invoke(on_message_cb, id, message.data(), message.size());
     }
 
-    void publish_ex(std::vector<nil::service::ID> ids, std::vector<std::uint8_t> message) override
+    void publish_ex(std::vector<nil::service::ID> ids, nil::service::Payload message) override
     {
         if (ids.end() == std::find(ids.begin(), ids.end(), id))
         {
@@ -94,10 +95,23 @@ public:
         }
     }
 
-    void send(std::vector<nil::service::ID> target_id, std::vector<std::uint8_t> message) override
+    void send(std::vector<nil::service::ID> target_id, nil::service::Payload message) override
     {
-        (void)target_id;
-        (void)message;
+        if (target_id.end() != std::find(target_id.begin(), target_id.end(), id))
+        {
+            nil::service::utils::invoke(on_message_cb, id, message.data(), message.size());
+        }
+    }
+
+    void publish_some(nil::service::Payload piece, bool last) override
+    {
+        pieces.publish_some(*this, std::move(piece), last);
+    }
+
+    void send_some(std::vector<nil::service::ID> ids, nil::service::Payload piece, bool last)
+        override
+    {
+        pieces.send_some(*this, std::move(ids), std::move(piece), last);
     }
 
     using IMessageService::publish;
@@ -106,6 +120,7 @@ public:
 
 private:
     nil::service::ID id;
+    nil::service::Pieces pieces;
 
     std::vector<std::function<void(nil::service::ID, const void*, std::uint64_t)>> on_message_cb;
     std::vector<std::function<void(nil::service::ID)>> on_ready_cb;
@@ -158,6 +173,74 @@ TEST(BaseService, on_message)
     service.stop();
 }
 
+TEST(BaseService, publish_some_without_streaming)
+{
+    const testing::InSequence _;
+    testing::StrictMock<testing::MockFunction<void(std::string)>> mock;
+
+    TestService service;
+    service.on_message([&](const void* data, std::uint64_t size)
+                       { mock.Call(std::string(static_cast<const char*>(data), size)); });
+
+    // services without streaming join the pieces into one message
+    EXPECT_CALL(mock, Call("abc")).Times(1);
+    service.publish_some(nil::service::Payload("ab", 2), false);
+    service.publish_some(nil::service::Payload("c", 1), true);
+    EXPECT_CALL(mock, Call("d")).Times(1);
+    service.publish_some(nil::service::Payload("d", 1), true);
+}
+
+TEST(BaseService, send_some_without_streaming_interleaved)
+{
+    using nil::service::Payload;
+
+    const testing::InSequence _;
+    testing::StrictMock<testing::MockFunction<void(std::string)>> mock;
+
+    static constexpr auto other = "other id";
+    const auto self = nil::service::mock_peer_id();
+    const auto peer = nil::service::ID{&other, other, &nil::service::mock_peer_id_to_string};
+
+    TestService service;
+    service.on_message([&](const void* data, std::uint64_t size)
+                       { mock.Call(std::string(static_cast<const char*>(data), size)); });
+
+    // the open messages of publish_some and of every set of ids are joined apart
+    service.publish_some(Payload("ab", 2), false);
+    service.send_some({self}, Payload("xy", 2), false);
+    service.send_some({peer}, Payload("12", 2), false);
+    service.send_some({self, peer}, Payload("--", 2), false);
+    EXPECT_CALL(mock, Call("abc")).Times(1);
+    service.publish_some(Payload("c", 1), true);
+    EXPECT_CALL(mock, Call("xyz")).Times(1);
+    service.send_some({self}, Payload("z", 1), true);
+    // not for this service
+    service.send_some({peer}, Payload("3", 1), true);
+    EXPECT_CALL(mock, Call("---")).Times(1);
+    service.send_some({self, peer}, Payload("-", 1), true);
+    EXPECT_CALL(mock, Call("d")).Times(1);
+    service.send_some({self}, Payload("d", 1), true);
+}
+
+TEST(BaseService, on_piece_without_streaming)
+{
+    const testing::InSequence _;
+    testing::StrictMock<testing::MockFunction<void(std::string)>> mock;
+
+    TestService service;
+    service.on_piece(
+        [&](const nil::service::ID&, const void* data, std::uint64_t size, nil::service::Piece p)
+        {
+            // every message is a single piece
+            ASSERT_TRUE(p.first && p.last);
+            mock.Call(std::string(static_cast<const char*>(data), size));
+        }
+    );
+
+    EXPECT_CALL(mock, Call("ab")).Times(1);
+    service.publish({'a', 'b'});
+}
+
 TEST(BaseService, on_message_with_id)
 {
     const testing::InSequence _;
@@ -80,3 +80,41 @@ TEST(create_message_handler, three_args)
     // clang-format on
 #undef THIS_CHECK
 }
+
+TEST(create_message_handler, payload)
+{
+    using nil::service::Payload;
+    using nil::service::detail::create_message_handler;
+    using nil::service::detail::Lend;
+
+    const Payload buffer(std::vector<std::uint8_t>{1, 2, 3, 4});
+    const std::uint8_t other[] = {5, 6}; // NOLINT
+
+    Payload received;
+    auto cb = create_message_handler([&](nil::service::ID, Payload p) { received = std::move(p); });
+
+    {
+        const auto lend = Lend(buffer);
+        // within the lent buffer: shared
+        cb(nil::service::ID{}, buffer.data() + 1, 2);
+        EXPECT_EQ(received.data(), buffer.data() + 1);
+        EXPECT_EQ(received.size(), 2);
+
+        // outside of it: copied
+        cb(nil::service::ID{}, &other[0], sizeof(other));
+        EXPECT_NE(received.data(), &other[0]);
+        EXPECT_EQ(
+            std::vector<std::uint8_t>(received.begin(), received.end()),
+            (std::vector<std::uint8_t>{5, 6})
+        );
+    }
+
+    // nothing lent: copied
+    cb(nil::service::ID{}, buffer.data(), buffer.size());
+    EXPECT_NE(received.data(), buffer.data());
+    EXPECT_EQ(received.size(), 4);
+
+    auto data_only = create_message_handler([&](Payload p) { received = std::move(p); });
+    data_only(nil::service::ID{}, &other[0], sizeof(other));
+    EXPECT_EQ(received.size(), 2);
+}
@@ -0,0 +1,205 @@
+#include "../../src/src/udp/Fragments.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Datagrams = std::vector<std::vector<std::uint8_t>>;
+
+    Datagrams split(std::uint64_t mtu, std::uint32_t id, const std::string& payload)
+    {
+        Datagrams datagrams;
+        const auto fits = nil::service::udp::split(
+            mtu,
+            id,
+            boost::asio::buffer(payload),
+            [&](boost::asio::const_buffer header, boost::asio::const_buffer body)
+            {
+                const auto* h = static_cast<const std::uint8_t*>(header.data());
+                const auto* b = static_cast<const std::uint8_t*>(body.data());
+                auto& datagram = datagrams.emplace_back(h, h + header.size());
+                datagram.insert(datagram.end(), b, b + body.size());
+            }
+        );
+        EXPECT_TRUE(fits);
+        return datagrams;
+    }
+
+    std::string to_string(const std::vector<std::uint8_t>& data)
+    {
+        return {data.begin(), data.end()};
+    }
+}
+
+TEST(fragments, splits_into_datagrams_of_at_most_mtu)
+{
+    EXPECT_FALSE(nil::service::udp::needs_fragments(0, 100000));
+    EXPECT_FALSE(nil::service::udp::needs_fragments(64, 63));
+    EXPECT_TRUE(nil::service::udp::needs_fragments(64, 64));
+
+    const auto datagrams = split(64, 1, std::string(200, 'x'));
+    // 51 bytes of payload per fragment
+    ASSERT_EQ(datagrams.size(), 4);
+    for (const auto& datagram : datagrams)
+    {
+        EXPECT_LE(datagram.size(), 64);
+        EXPECT_EQ(datagram[0], nil::service::utils::UDP_FRAGMENT_MESSAGE);
+    }
+}
+
+TEST(fragments, reassembles_out_of_order_and_ignores_duplicates)
+{
+    std::string payload;
+    for (auto i = 0u; i < 500u; ++i)
+    {
+        payload.push_back(char('a' + i % 26));
+    }
+
+    auto datagrams = split(64, 7, payload);
+    std::reverse(datagrams.begin(), datagrams.end());
+    datagrams.insert(datagrams.begin() + 1, datagrams.front());
+
+    nil::service::udp::Reassembler reassembler({});
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::string> messages;
+    for (const auto& datagram : datagrams)
+    {
+        if (auto msg = reassembler.add(nullptr, datagram.data(), datagram.size(), now))
+        {
+            messages.push_back(to_string(*msg));
+        }
+    }
+    EXPECT_EQ(messages, std::vector<std::string>{payload});
+    EXPECT_EQ(reassembler.pending(), 0);
+    EXPECT_EQ(reassembler.bytes(), 0);
+}
+
+TEST(fragments, keeps_messages_of_peers_apart)
+{
+    // 19 bytes of payload per fragment
+    const auto a = split(32, 1, std::string(30, 'a'));
+    const auto b = split(32, 1, std::string(30, 'b'));
+    const int peer_a = 0;
+    const int peer_b = 0;
+
+    nil::service::udp::Reassembler reassembler({});
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_FALSE(reassembler.add(&peer_a, a[0].data(), a[0].size(), now));
+    EXPECT_FALSE(reassembler.add(&peer_b, b[1].data(), b[1].size(), now));
+    const auto msg_a = reassembler.add(&peer_a, a[1].data(), a[1].size(), now);
+    const auto msg_b = reassembler.add(&peer_b, b[0].data(), b[0].size(), now);
+    ASSERT_TRUE(msg_a && msg_b);
+    EXPECT_EQ(to_string(*msg_a), std::string(30, 'a'));
+    EXPECT_EQ(to_string(*msg_b), std::string(30, 'b'));
+}
+
+TEST(fragments, drops_incomplete_messages)
+{
+    nil::service::udp::Fragmentation options;
+    options.timeout_ms = 100;
+    options.max_bytes = 300;
+    nil::service::udp::Reassembler reassembler(options);
+    const auto now = std::chrono::steady_clock::now();
+
+    const auto first = split(32, 1, std::string(40, 'x'));
+    EXPECT_FALSE(reassembler.add(nullptr, first[0].data(), first[0].size(), now));
+    EXPECT_EQ(reassembler.pending(), 1);
+    reassembler.expire(now + 50ms);
+    EXPECT_EQ(reassembler.pending(), 1);
+    reassembler.expire(now + 100ms);
+    EXPECT_EQ(reassembler.pending(), 0);
+    EXPECT_EQ(reassembler.bytes(), 0);
+
+    // over the memory cap
+    const auto large = split(32, 2, std::string(400, 'x'));
+    for (const auto& datagram : large)
+    {
+        EXPECT_FALSE(reassembler.add(nullptr, datagram.data(), datagram.size(), now));
+    }
+    EXPECT_LE(reassembler.bytes(), 300);
+
+    const auto other = split(32, 3, std::string(40, 'x'));
+    EXPECT_FALSE(reassembler.add(&options, other[0].data(), other[0].size(), now));
+    reassembler.forget(&options);
+    EXPECT_EQ(reassembler.pending(), 0);
+}
+
+TEST(fragments, counts_bookkeeping_against_the_cap)
+{
+    // first fragment of a message announcing 65535 fragments, with a single byte of data
+    auto datagram = split(64, 1, "x").front();
+    datagram[7] = 0xFF;
+    datagram[8] = 0xFF;
+
+    nil::service::udp::Fragmentation options;
+    options.max_bytes = 4096;
+    nil::service::udp::Reassembler small(options);
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_FALSE(small.add(nullptr, datagram.data(), datagram.size(), now));
+    EXPECT_EQ(small.pending(), 0);
+    EXPECT_EQ(small.bytes(), 0);
+
+    nil::service::udp::Reassembler large({});
+    EXPECT_FALSE(large.add(nullptr, datagram.data(), datagram.size(), now));
+    EXPECT_EQ(large.pending(), 1);
+    EXPECT_GT(large.bytes(), 65535 / 8);
+}
+
+TEST(fragments, limits_pending_messages_per_peer)
+{
+    nil::service::udp::Fragmentation options;
+    options.max_pending = 2;
+    nil::service::udp::Reassembler reassembler(options);
+    const auto now = std::chrono::steady_clock::now();
+    const int peer_a = 0;
+    const int peer_b = 0;
+
+    for (std::uint32_t id = 0; id < 4; ++id)
+    {
+        const auto datagram = split(32, id, std::string(40, 'x')).front();
+        EXPECT_FALSE(reassembler.add(&peer_a, datagram.data(), datagram.size(), now));
+    }
+    EXPECT_EQ(reassembler.pending(), 2);
+
+    // other peers are not affected
+    const auto other = split(32, 0, std::string(40, 'x')).front();
+    EXPECT_FALSE(reassembler.add(&peer_b, other.data(), other.size(), now));
+    EXPECT_EQ(reassembler.pending(), 3);
+
+    // a completed message frees its place
+    const auto fragments = split(32, 1, std::string(40, 'x'));
+    for (std::size_t i = 1; i < fragments.size(); ++i)
+    {
+        reassembler.add(&peer_a, fragments[i].data(), fragments[i].size(), now);
+    }
+    const auto next = split(32, 9, std::string(40, 'x')).front();
+    EXPECT_FALSE(reassembler.add(&peer_a, next.data(), next.size(), now));
+    EXPECT_EQ(reassembler.pending(), 3);
+}
+
+TEST(fragments, rejects_payloads_over_the_fragment_limits)
+{
+    // a single byte per fragment: 65535 fragments at most
+    constexpr auto mtu = nil::service::udp::FRAGMENT_HEADER_SIZE + 1;
+    const std::string payload(65536, 'x');
+    std::size_t sent = 0;
+    EXPECT_FALSE(nil::service::udp::split(
+        mtu,
+        1,
+        boost::asio::buffer(payload),
+        [&](boost::asio::const_buffer, boost::asio::const_buffer) { ++sent; }
+    ));
+    EXPECT_EQ(sent, 0);
+    EXPECT_THROW(nil::service::udp::check_fragments(mtu, payload.size()), std::length_error);
+    EXPECT_NO_THROW(nil::service::udp::check_fragments(mtu, payload.size() - 1));
+    EXPECT_NO_THROW(nil::service::udp::check_fragments(0, payload.size()));
+}
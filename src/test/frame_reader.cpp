@@ -0,0 +1,136 @@
+#include "../../src/src/FrameReader.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::vector<std::uint8_t> frame(const std::string& body)
+    {
+        const auto header = nil::service::utils::to_array<std::uint64_t>(body.size());
+        std::vector<std::uint8_t> retval(header.begin(), header.end());
+        retval.insert(retval.end(), body.begin(), body.end());
+        return retval;
+    }
+
+    // feeds `stream` in reads of at most `chunk` bytes
+    bool feed(
+        nil::service::FrameReader& reader,
+        const std::vector<std::uint8_t>& stream,
+        std::size_t chunk,
+        std::vector<std::string>& frames
+    )
+    {
+        for (std::size_t pos = 0; pos < stream.size();)
+        {
+            const auto buffer = reader.prepare();
+            const auto count = std::min({chunk, buffer.size(), stream.size() - pos});
+            std::copy_n(stream.data() + pos, count, static_cast<std::uint8_t*>(buffer.data()));
+            reader.commit(count);
+            pos += count;
+            const auto valid = reader.consume(
+                [&](const std::uint8_t* data, std::uint64_t size)
+                { frames.emplace_back(reinterpret_cast<const char*>(data), size); }
+            );
+            if (!valid)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(frame_reader, parses_all_frames_of_one_read)
+{
+    std::vector<std::uint8_t> stream;
+    for (const auto* body : {"a", "", "bc", "def"})
+    {
+        const auto f = frame(body);
+        stream.insert(stream.end(), f.begin(), f.end());
+    }
+
+    nil::service::FrameReader reader(64, 64, std::chrono::seconds(1));
+    std::vector<std::string> frames;
+    ASSERT_TRUE(feed(reader, stream, stream.size(), frames));
+    EXPECT_EQ(frames, (std::vector<std::string>{"a", "", "bc", "def"}));
+}
+
+TEST(frame_reader, joins_frames_split_across_reads)
+{
+    std::vector<std::uint8_t> stream;
+    std::vector<std::string> expected;
+    for (auto i = 0u; i < 20u; ++i)
+    {
+        expected.emplace_back(i, char('a' + i));
+        const auto f = frame(expected.back());
+        stream.insert(stream.end(), f.begin(), f.end());
+    }
+
+    for (auto chunk : {1u, 3u, 7u, 13u})
+    {
+        nil::service::FrameReader reader(20, 20, std::chrono::seconds(1));
+        std::vector<std::string> frames;
+        ASSERT_TRUE(feed(reader, stream, chunk, frames));
+        EXPECT_EQ(frames, expected);
+    }
+}
+
+TEST(frame_reader, rejects_oversized_frame)
+{
+    nil::service::FrameReader reader(4, 4, std::chrono::seconds(1));
+    std::vector<std::string> frames;
+    EXPECT_TRUE(feed(reader, frame("1234"), 64, frames));
+    EXPECT_FALSE(feed(reader, frame("12345"), 64, frames));
+    EXPECT_EQ(frames, (std::vector<std::string>{"1234"}));
+}
+
+TEST(frame_reader, grows_up_to_max_payload)
+{
+    nil::service::FrameReader reader(4, 64, std::chrono::seconds(1));
+    std::vector<std::string> frames;
+    const auto body = std::string(64, 'x');
+    ASSERT_TRUE(feed(reader, frame(body), 5, frames));
+    EXPECT_TRUE(reader.grown());
+    EXPECT_EQ(frames, (std::vector<std::string>{body}));
+    EXPECT_FALSE(feed(reader, frame(body + "x"), 5, frames));
+}
+
+TEST(frame_reader, releases_grown_storage_when_idle)
+{
+    nil::service::FrameReader reader(4, 64, std::chrono::seconds(0));
+    std::vector<std::string> frames;
+    ASSERT_TRUE(feed(reader, frame(std::string(32, 'x')), 64, frames));
+    EXPECT_TRUE(reader.grown());
+    // the buffer is drained so the next read goes to the small storage
+    EXPECT_EQ(reader.prepare().size(), 4 + sizeof(std::uint64_t));
+    EXPECT_TRUE(reader.release_idle());
+    EXPECT_FALSE(reader.grown());
+}
+
+TEST(frame_reader, kept_frame_survives_next_read)
+{
+    nil::service::FrameReader reader(64, 64, std::chrono::seconds(1));
+    std::vector<nil::service::Payload> kept;
+    for (const auto* body : {"first", "second"})
+    {
+        const auto f = frame(body);
+        const auto buffer = reader.prepare();
+        std::copy(f.begin(), f.end(), static_cast<std::uint8_t*>(buffer.data()));
+        reader.commit(f.size());
+        ASSERT_TRUE(reader.consume(
+            [&](const std::uint8_t* data, std::uint64_t size)
+            { kept.push_back(nil::service::detail::Lend::adopt(data, size)); }
+        ));
+    }
+    ASSERT_EQ(kept.size(), 2);
+    EXPECT_EQ(std::string(kept[0].begin(), kept[0].end()), "first");
+    EXPECT_EQ(std::string(kept[1].begin(), kept[1].end()), "second");
+}
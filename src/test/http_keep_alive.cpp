@@ -0,0 +1,164 @@
+#include <nil/service/http/server/create.hpp>
+
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    namespace ns = nil::service;
+
+    constexpr auto REQUEST = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n";
+
+    // a server answering "ok" to GET /, run by its own thread
+    struct Server final
+    {
+        explicit Server(ns::http::server::Options options)
+            : service(ns::http::server::create(std::move(options)))
+        {
+            service->on_ready([this]() { ready = true; });
+            service->on_get(
+                [](ns::WebTransaction& transaction)
+                {
+                    ns::set_content_type(transaction, "text/plain");
+                    ns::send(transaction, "ok");
+                    return true;
+                }
+            );
+            thread = std::thread([this]() { service->run(); });
+        }
+
+        ~Server()
+        {
+            service->stop();
+            thread.join();
+        }
+
+        Server(Server&&) = delete;
+        Server(const Server&) = delete;
+        Server& operator=(Server&&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        std::unique_ptr<ns::IWebService> service;
+        std::atomic<bool> ready = false;
+        std::thread thread;
+    };
+
+    bool wait_ready(const Server& server)
+    {
+        const auto until = std::chrono::steady_clock::now() + 10s;
+        while (!server.ready)
+        {
+            if (std::chrono::steady_clock::now() > until)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    // a blocking client socket, reads give up after 5s
+    int connect_to(std::uint16_t port)
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        const timeval timeout = {.tv_sec = 5, .tv_usec = 0};
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool write_request(int fd)
+    {
+        const auto request = std::string(REQUEST);
+        return ::send(fd, request.data(), request.size(), MSG_NOSIGNAL)
+            == static_cast<ssize_t>(request.size());
+    }
+
+    // reads one response with the "ok" body, empty when the connection ends before
+    std::string read_response(int fd)
+    {
+        std::string response;
+        char chunk[1024];
+        while (response.find("\r\n\r\nok") == std::string::npos)
+        {
+            const auto count = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (count <= 0)
+            {
+                return {};
+            }
+            response.append(chunk, std::size_t(count));
+        }
+        return response;
+    }
+
+    // true when the server closed the connection (as opposed to a read timeout)
+    bool closed_by_server(int fd)
+    {
+        char byte = 0;
+        return ::recv(fd, &byte, 1, 0) == 0;
+    }
+}
+
+TEST(http_keep_alive, serves_requests_on_one_connection_until_max_requests)
+{
+    Server server({.host = "127.0.0.1", .port = 17321, .max_requests = 2});
+    ASSERT_TRUE(wait_ready(server));
+
+    const int fd = connect_to(17321);
+    ASSERT_GE(fd, 0);
+
+    ASSERT_TRUE(write_request(fd));
+    const auto first = read_response(fd);
+    ASSERT_FALSE(first.empty());
+    EXPECT_EQ(first.find("Connection: close"), std::string::npos);
+
+    // same socket
+    ASSERT_TRUE(write_request(fd));
+    const auto second = read_response(fd);
+    ASSERT_FALSE(second.empty());
+    EXPECT_NE(second.find("Connection: close"), std::string::npos);
+
+    EXPECT_TRUE(closed_by_server(fd));
+    ::close(fd);
+}
+
+TEST(http_keep_alive, closes_an_idle_connection_after_keep_alive_ms)
+{
+    Server server({.host = "127.0.0.1", .port = 17322, .keep_alive_ms = 100});
+    ASSERT_TRUE(wait_ready(server));
+
+    const int fd = connect_to(17322);
+    ASSERT_GE(fd, 0);
+
+    ASSERT_TRUE(write_request(fd));
+    const auto response = read_response(fd);
+    ASSERT_FALSE(response.empty());
+    EXPECT_EQ(response.find("Connection: close"), std::string::npos);
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(closed_by_server(fd));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 4s);
+    ::close(fd);
+}
@@ -0,0 +1,122 @@
+#include "../../src/src/Outbound.hpp"
+
+#include <nil/service/tcp/client/create.hpp>
+#include <nil/service/tcp/server/create.hpp>
+#include <nil/service/ws/client/create.hpp>
+#include <nil/service/ws/server/create.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using nil::service::Backpressure;
+    using nil::service::Outbound;
+
+    template <typename Predicate>
+    bool wait_for(Predicate predicate)
+    {
+        const auto until = std::chrono::steady_clock::now() + 5s;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > until)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+}
+
+TEST(outbound, posted_payload_is_not_counted_by_the_connections)
+{
+    Outbound outbound({.max_service_bytes = 1000});
+    auto ticket = outbound.admit(600, false);
+    ASSERT_TRUE(ticket.has_value());
+    // the connection queuing the posted payload
+    EXPECT_FALSE(outbound.exceeds(600));
+    outbound.add(600);
+    EXPECT_TRUE(outbound.exceeds(600));
+}
+
+TEST(outbound, drop_newest_counts_posted_and_queued_bytes)
+{
+    Outbound outbound({.max_service_bytes = 1000});
+    auto first = outbound.admit(600, false);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_FALSE(outbound.admit(600, false).has_value());
+    first.reset();
+    EXPECT_TRUE(outbound.admit(600, false).has_value());
+}
+
+TEST(outbound, tcp_delivers_payload_over_half_the_service_limit)
+{
+    namespace ns = nil::service;
+    constexpr std::uint16_t port = 17301;
+    auto server = ns::tcp::server::create(
+        {.host = "127.0.0.1",
+         .port = port,
+         .backpressure = {.max_service_bytes = 1000, .policy = Backpressure::Policy::drop_newest}}
+    );
+    auto client = ns::tcp::client::create({.host = "127.0.0.1", .port = port});
+
+    std::atomic<int> connected = 0;
+    std::atomic<int> backpressure = 0;
+    std::atomic<std::uint64_t> received = 0;
+    server->on_connect([&]() { ++connected; });
+    server->on_backpressure([&]() { ++backpressure; });
+    client->on_message([&](const void*, std::uint64_t size) { received = size; });
+
+    std::thread server_thread([&]() { server->run(); });
+    std::thread client_thread([&]() { client->run(); });
+    ASSERT_TRUE(wait_for([&]() { return connected == 1; }));
+
+    server->publish(std::vector<std::uint8_t>(600, 1));
+    EXPECT_TRUE(wait_for([&]() { return received == 600; }));
+    EXPECT_EQ(backpressure, 0);
+
+    client->stop();
+    server->stop();
+    client_thread.join();
+    server_thread.join();
+}
+
+TEST(outbound, ws_delivers_payload_over_half_the_service_limit)
+{
+    namespace ns = nil::service;
+    constexpr std::uint16_t port = 17302;
+    auto server = ns::ws::server::create(
+        {.host = "127.0.0.1",
+         .port = port,
+         .backpressure = {.max_service_bytes = 1000, .policy = Backpressure::Policy::drop_newest}}
+    );
+    auto client = ns::ws::client::create({.host = "127.0.0.1", .port = port});
+
+    std::atomic<int> connected = 0;
+    std::atomic<int> backpressure = 0;
+    std::atomic<std::uint64_t> received = 0;
+    server->on_connect([&]() { ++connected; });
+    server->on_backpressure([&]() { ++backpressure; });
+    client->on_message([&](const void*, std::uint64_t size) { received = size; });
+
+    std::thread server_thread([&]() { server->run(); });
+    std::thread client_thread([&]() { client->run(); });
+    ASSERT_TRUE(wait_for([&]() { return connected == 1; }));
+
+    server->publish(std::vector<std::uint8_t>(600, 1));
+    EXPECT_TRUE(wait_for([&]() { return received == 600; }));
+    EXPECT_EQ(backpressure, 0);
+
+    client->stop();
+    server->stop();
+    client_thread.join();
+    server_thread.join();
+}
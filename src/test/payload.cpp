@@ -0,0 +1,70 @@
+#include <nil/service/payload.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(payload, empty)
+{
+    const nil::service::Payload payload;
+    EXPECT_TRUE(payload.empty());
+    EXPECT_EQ(payload.size(), 0);
+    EXPECT_EQ(payload.begin(), payload.end());
+}
+
+TEST(payload, adopts_vector)
+{
+    auto data = std::vector<std::uint8_t>{1, 2, 3};
+    const auto* bytes = data.data();
+    const nil::service::Payload payload(std::move(data));
+    EXPECT_EQ(payload.data(), bytes);
+    EXPECT_EQ(payload.size(), 3);
+}
+
+TEST(payload, copies_raw)
+{
+    const std::uint8_t data[] = {1, 2, 3}; // NOLINT
+    const nil::service::Payload payload(&data[0], sizeof(data));
+    EXPECT_NE(payload.data(), &data[0]);
+    EXPECT_EQ(
+        std::vector<std::uint8_t>(payload.begin(), payload.end()),
+        (std::vector<std::uint8_t>{1, 2, 3})
+    );
+}
+
+TEST(payload, copies_share_bytes)
+{
+    const nil::service::Payload payload(std::vector<std::uint8_t>{1, 2, 3});
+    const auto copy = payload; // NOLINT(performance-unnecessary-copy-initialization)
+    EXPECT_EQ(copy.data(), payload.data());
+    EXPECT_EQ(copy.size(), payload.size());
+}
+
+TEST(payload, create)
+{
+    const auto payload = nil::service::Payload::create(
+        3,
+        [](std::uint8_t* bytes)
+        {
+            bytes[0] = 1;
+            bytes[1] = 2;
+            bytes[2] = 3;
+        }
+    );
+    EXPECT_EQ(
+        std::vector<std::uint8_t>(payload.begin(), payload.end()),
+        (std::vector<std::uint8_t>{1, 2, 3})
+    );
+}
+
+TEST(payload, slice_shares_bytes)
+{
+    const nil::service::Payload payload(std::vector<std::uint8_t>{1, 2, 3, 4});
+    const auto slice = payload.slice(1, 2);
+    EXPECT_EQ(slice.data(), payload.data() + 1);
+    EXPECT_EQ(
+        std::vector<std::uint8_t>(slice.begin(), slice.end()),
+        (std::vector<std::uint8_t>{2, 3})
+    );
+}
@@ -0,0 +1,75 @@
+#include <nil/service/payload.hpp>
+#include <nil/service/pool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST(pool, reuses_released_buffer)
+{
+    nil::service::pool::trim();
+    const auto* first = nil::service::pool::allocate(100).get();
+    const auto before = nil::service::pool::stats();
+    EXPECT_GT(before.cached, 0);
+
+    // same size class (128 bytes)
+    const auto second = nil::service::pool::allocate(120);
+    const auto after = nil::service::pool::stats();
+    EXPECT_EQ(second.get(), first);
+    EXPECT_GT(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses);
+}
+
+TEST(pool, payload_steady_state_hits)
+{
+    nil::service::pool::trim();
+    for (auto i = 0; i < 2; ++i)
+    {
+        const nil::service::Payload payload(std::vector<std::uint8_t>(64, 1));
+        const auto copy = nil::service::Payload(payload.data(), payload.size());
+    }
+    const auto before = nil::service::pool::stats();
+    for (auto i = 0; i < 100; ++i)
+    {
+        const auto payload = nil::service::Payload::create(
+            1000,
+            [](std::uint8_t* bytes) { bytes[0] = 1; }
+        );
+        EXPECT_EQ(payload.data()[0], 1);
+    }
+    const auto after = nil::service::pool::stats();
+    EXPECT_EQ(after.misses, before.misses + 1);
+    EXPECT_EQ(after.hits, before.hits + 199);
+}
+
+TEST(pool, oversized_is_not_cached)
+{
+    nil::service::pool::trim();
+    const auto before = nil::service::pool::stats();
+    nil::service::pool::allocate(std::uint64_t(4) << 20).reset();
+    const auto after = nil::service::pool::stats();
+    // the reference count is pooled, the bytes are not
+    EXPECT_EQ(after.misses, before.misses + 2);
+    EXPECT_EQ(after.cached, before.cached + 1);
+    EXPECT_LT(after.cached_bytes, 1024);
+}
+
+TEST(pool, released_by_another_thread)
+{
+    nil::service::pool::trim();
+    std::vector<nil::service::Payload> payloads;
+    for (auto i = 0; i < 10; ++i)
+    {
+        payloads.emplace_back(nil::service::Payload::create(10, [](std::uint8_t*) {}));
+    }
+    std::thread([&]() { payloads.clear(); }).join();
+    // the exited thread gave its buffers to the shared cache
+    const auto before = nil::service::pool::stats();
+    EXPECT_EQ(before.cached, 20);
+    const auto payload = nil::service::Payload::create(10, [](std::uint8_t*) {});
+    const auto after = nil::service::pool::stats();
+    EXPECT_EQ(after.hits, before.hits + 2);
+    EXPECT_EQ(after.misses, before.misses);
+}
@@ -0,0 +1,47 @@
+#include "../../src/src/Registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+TEST(registry, finds_added_items)
+{
+    nil::service::Registry<int> registry;
+    auto& a = registry.add(std::make_unique<int>(1));
+    auto& b = registry.add(std::make_unique<int>(2));
+
+    EXPECT_EQ(registry.size(), 2);
+    EXPECT_EQ(registry.find(&a), &a);
+    EXPECT_EQ(registry.find(&b), &b);
+    EXPECT_EQ(registry.find(nullptr), nullptr);
+}
+
+TEST(registry, remove_keeps_others_reachable)
+{
+    nil::service::Registry<int> registry;
+    std::vector<int*> items;
+    for (auto i = 0; i < 5; ++i)
+    {
+        items.push_back(&registry.add(std::make_unique<int>(i)));
+    }
+
+    auto removed = registry.remove(items[1]);
+    ASSERT_NE(removed, nullptr);
+    EXPECT_EQ(*removed, 1);
+    EXPECT_EQ(registry.remove(items[1]), nullptr);
+    EXPECT_EQ(registry.find(items[1]), nullptr);
+
+    EXPECT_EQ(registry.size(), 4);
+    for (auto i : {0, 2, 3, 4})
+    {
+        EXPECT_EQ(registry.find(items[i]), items[i]);
+    }
+
+    auto sum = 0;
+    for (const auto& item : registry)
+    {
+        sum += *item;
+    }
+    EXPECT_EQ(sum, 0 + 2 + 3 + 4);
+}
@@ -0,0 +1,176 @@
+#include "../../src/src/udp/Reliable.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Channel = nil::service::udp::ReliableChannel;
+    using Datagram = std::vector<std::uint8_t>;
+
+    struct Sender final
+    {
+        std::vector<Datagram> sent;
+
+        void operator()(boost::asio::const_buffer header, boost::asio::const_buffer body)
+        {
+            const auto* h = static_cast<const std::uint8_t*>(header.data());
+            const auto* b = static_cast<const std::uint8_t*>(body.data());
+            auto& datagram = sent.emplace_back(h, h + header.size());
+            datagram.insert(datagram.end(), b, b + body.size());
+        }
+
+        std::vector<Datagram> take()
+        {
+            return std::exchange(sent, {});
+        }
+    };
+
+    Datagram datagram(const std::string& text)
+    {
+        return {text.begin(), text.end()};
+    }
+
+    struct Peer final
+    {
+        Channel channel;
+        std::vector<std::string> delivered;
+
+        // returns the acknowledgement
+        Datagram receive(const Datagram& data)
+        {
+            const auto ack = channel.receive(
+                data.data(),
+                data.size(),
+                [this](const std::uint8_t* d, std::uint64_t s)
+                { delivered.emplace_back(reinterpret_cast<const char*>(d), s); }
+            );
+            return ack ? Datagram(ack->begin(), ack->end()) : Datagram();
+        }
+    };
+}
+
+TEST(reliable, delivers_in_order_despite_reordering)
+{
+    const nil::service::udp::Reliability options{.enabled = true};
+    Channel sender(options);
+    Peer receiver{Channel(options), {}};
+    Sender link;
+
+    const auto now = Channel::clock::now();
+    for (const auto* text : {"a", "b", "c", "d"})
+    {
+        sender.push(datagram(text), now, link);
+    }
+
+    auto sent = link.take();
+    ASSERT_EQ(sent.size(), 4);
+    for (const auto index : {3, 1, 2, 0})
+    {
+        const auto ack = receiver.receive(sent[index]);
+        sender.acknowledge(ack.data(), ack.size(), now, link);
+    }
+    // a duplicate is acknowledged but not delivered again
+    receiver.receive(sent[0]);
+
+    EXPECT_EQ(receiver.delivered, (std::vector<std::string>{"a", "b", "c", "d"}));
+    EXPECT_TRUE(sender.idle());
+}
+
+TEST(reliable, retransmits_after_timeout)
+{
+    const nil::service::udp::Reliability options{.enabled = true, .min_rto_ms = 10};
+    Channel sender(options);
+    Peer receiver{Channel(options), {}};
+    Sender link;
+
+    const auto start = Channel::clock::now();
+    sender.push(datagram("lost"), start, link);
+    link.take();
+
+    sender.retransmit(start + 1ms, link);
+    EXPECT_TRUE(link.take().empty());
+
+    sender.retransmit(start + sender.timeout(), link);
+    const auto sent = link.take();
+    ASSERT_EQ(sent.size(), 1);
+    const auto ack = receiver.receive(sent[0]);
+    sender.acknowledge(ack.data(), ack.size(), start + sender.timeout(), link);
+    EXPECT_EQ(receiver.delivered, std::vector<std::string>{"lost"});
+    EXPECT_TRUE(sender.idle());
+}
+
+TEST(reliable, retransmits_holes_reported_by_selective_ack)
+{
+    const nil::service::udp::Reliability options{.enabled = true};
+    Channel sender(options);
+    Peer receiver{Channel(options), {}};
+    Sender link;
+
+    const auto start = Channel::clock::now();
+    sender.push(datagram("a"), start, link);
+    sender.push(datagram("b"), start, link);
+    const auto sent = link.take();
+
+    // "a" is lost, the ack of "b" reports it missing
+    const auto ack = receiver.receive(sent[1]);
+    EXPECT_TRUE(receiver.delivered.empty());
+    sender.acknowledge(ack.data(), ack.size(), start + sender.timeout(), link);
+    const auto resent = link.take();
+    ASSERT_EQ(resent.size(), 1);
+    EXPECT_EQ(resent[0], sent[0]);
+
+    receiver.receive(resent[0]);
+    EXPECT_EQ(receiver.delivered, (std::vector<std::string>{"a", "b"}));
+}
+
+TEST(reliable, limits_datagrams_in_flight_to_the_window)
+{
+    const nil::service::udp::Reliability options{.enabled = true, .window = 2};
+    Channel sender(options);
+    Peer receiver{Channel(options), {}};
+    Sender link;
+
+    const auto now = Channel::clock::now();
+    for (const auto* text : {"a", "b", "c"})
+    {
+        sender.push(datagram(text), now, link);
+    }
+    auto sent = link.take();
+    ASSERT_EQ(sent.size(), 2);
+
+    const auto ack = receiver.receive(sent[0]);
+    sender.acknowledge(ack.data(), ack.size(), now, link);
+    sent = link.take();
+    ASSERT_EQ(sent.size(), 1);
+    receiver.receive(sent[0]);
+    EXPECT_EQ(receiver.delivered, (std::vector<std::string>{"a"}));
+}
+
+TEST(reliable, restarts_the_stream_of_a_new_session)
+{
+    const nil::service::udp::Reliability options{.enabled = true};
+    Peer receiver{Channel(options), {}};
+    Sender link;
+
+    const auto now = Channel::clock::now();
+    Channel first(options);
+    first.push(datagram("a"), now, link);
+    first.push(datagram("b"), now, link);
+    for (const auto& sent : link.take())
+    {
+        receiver.receive(sent);
+    }
+
+    Channel second(options);
+    second.push(datagram("c"), now, link);
+    receiver.receive(link.take().front());
+    EXPECT_EQ(receiver.delivered, (std::vector<std::string>{"a", "b", "c"}));
+}
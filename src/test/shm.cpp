@@ -0,0 +1,205 @@
+#include <nil/service/shm/create.hpp>
+
+#include <gtest/gtest.h>
+
+#if NIL_SERVICE_SHM_SUPPORTED
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    namespace ns = nil::service;
+
+    template <typename Predicate>
+    bool wait_for(Predicate predicate)
+    {
+        const auto until = std::chrono::steady_clock::now() + 10s;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > until)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    ns::shm::Options small_ring(const char* name)
+    {
+        return {
+            .name = "/nil_service_test_" + std::to_string(::getpid()) + "_" + name,
+            .capacity = 4096,
+            .spin_us = 50
+        };
+    }
+
+    // a service run by its own thread
+    struct Side final
+    {
+        explicit Side(ns::shm::Options options)
+            : service(ns::shm::create(std::move(options)))
+        {
+            service->on_connect([this]() { ++connected; });
+        }
+
+        ~Side()
+        {
+            service->stop();
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+
+        Side(Side&&) = delete;
+        Side(const Side&) = delete;
+        Side& operator=(Side&&) = delete;
+        Side& operator=(const Side&) = delete;
+
+        void start()
+        {
+            thread = std::thread([this]() { service->run(); });
+        }
+
+        std::unique_ptr<ns::IStandaloneService> service;
+        std::atomic<int> connected = 0;
+        std::thread thread;
+    };
+
+    std::vector<std::uint8_t> numbered(std::uint32_t number, std::size_t size)
+    {
+        std::vector<std::uint8_t> message(size, 0);
+        std::memcpy(message.data(), &number, sizeof(number));
+        return message;
+    }
+}
+
+TEST(shm, delivers_in_order_from_a_publishing_thread)
+{
+    const auto options = small_ring("order");
+    Side a(options);
+    Side b(options);
+    std::atomic<std::uint32_t> received = 0;
+    std::atomic<bool> ordered = true;
+    b.service->on_message(
+        [&](const void* data, std::uint64_t)
+        {
+            std::uint32_t number = 0;
+            std::memcpy(&number, data, sizeof(number));
+            ordered = ordered && number == received;
+            ++received;
+        }
+    );
+    a.start();
+    b.start();
+    ASSERT_TRUE(wait_for([&]() { return a.connected == 1 && b.connected == 1; }));
+
+    // many times the ring: the publishing thread waits for room
+    constexpr std::uint32_t count = 2000;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        a.service->publish(numbered(i, 512));
+    }
+    EXPECT_TRUE(wait_for([&]() { return received == count; }));
+    EXPECT_TRUE(ordered);
+}
+
+TEST(shm, service_thread_does_not_wait_for_a_blocked_writer)
+{
+    const auto options = small_ring("echo");
+    Side a(options);
+    Side b(options);
+    // both service threads publish from on_message while another thread floods the ring
+    std::atomic<int> echoes = 0;
+    for (auto* side : {&a, &b})
+    {
+        side->service->on_message(
+            [&echoes, service = side->service.get()](const void*, std::uint64_t size)
+            {
+                if (size == 512)
+                {
+                    service->publish(std::vector<std::uint8_t>(16, 0));
+                }
+                else
+                {
+                    ++echoes;
+                }
+            }
+        );
+    }
+    a.start();
+    b.start();
+    ASSERT_TRUE(wait_for([&]() { return a.connected == 1 && b.connected == 1; }));
+
+    std::atomic<int> done = 0;
+    auto flood = [&done](ns::IStandaloneService& service)
+    {
+        for (std::uint32_t i = 0; i < 2000; ++i)
+        {
+            service.publish(numbered(i, 512));
+        }
+        ++done;
+    };
+    std::thread flood_a([&]() { flood(*a.service); });
+    std::thread flood_b([&]() { flood(*b.service); });
+    const auto completed = wait_for([&]() { return done == 2; });
+    flood_a.join();
+    flood_b.join();
+    EXPECT_TRUE(completed);
+    // the echoes that found the ring busy are dropped
+    EXPECT_GT(echoes, 0);
+}
+
+TEST(shm, stop_releases_a_publisher_waiting_for_room)
+{
+    const auto options = small_ring("stop");
+    Side a(options);
+    Side b(options);
+    // the peer stops reading, the ring of `a` fills up
+    std::atomic<bool> hold = true;
+    b.service->on_message(
+        [&hold](const void*, std::uint64_t)
+        {
+            while (hold)
+            {
+                std::this_thread::sleep_for(1ms);
+            }
+        }
+    );
+    a.start();
+    b.start();
+    ASSERT_TRUE(wait_for([&]() { return a.connected == 1 && b.connected == 1; }));
+
+    std::atomic<bool> done = false;
+    std::thread publisher(
+        [&]()
+        {
+            for (std::uint32_t i = 0; i < 100; ++i)
+            {
+                a.service->publish(numbered(i, 512));
+            }
+            done = true;
+        }
+    );
+    std::this_thread::sleep_for(100ms);
+    EXPECT_FALSE(done);
+
+    a.service->stop();
+    const auto released = wait_for([&]() { return done.load(); });
+    hold = false;
+    publisher.join();
+    EXPECT_TRUE(released);
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "../../src/src/shm/Ring.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr std::uint64_t CAPACITY = 256;
+
+    struct Fixture
+    {
+        nil::service::shm::RingState state{};
+        std::vector<std::uint8_t> data = std::vector<std::uint8_t>(CAPACITY);
+        nil::service::shm::Ring ring{state, data.data(), CAPACITY};
+
+        bool write(const std::string& message)
+        {
+            return ring.write(message.data(), message.size());
+        }
+
+        std::vector<std::string> read(std::uint64_t limit = 100)
+        {
+            std::vector<std::string> messages;
+            ring.read(
+                [&](const std::uint8_t* message, std::uint64_t size)
+                { messages.emplace_back(reinterpret_cast<const char*>(message), size); },
+                limit
+            );
+            return messages;
+        }
+    };
+}
+
+TEST(shm_ring, reads_the_messages_in_order)
+{
+    Fixture f;
+    EXPECT_TRUE(f.ring.empty());
+    EXPECT_TRUE(f.write("a"));
+    EXPECT_TRUE(f.write("bcdefghij"));
+    EXPECT_TRUE(f.write(""));
+    EXPECT_FALSE(f.ring.empty());
+
+    EXPECT_EQ(f.read(2), (std::vector<std::string>{"a", "bcdefghij"}));
+    EXPECT_EQ(f.read(), (std::vector<std::string>{""}));
+    EXPECT_TRUE(f.ring.empty());
+}
+
+TEST(shm_ring, rejects_messages_without_room_until_read)
+{
+    Fixture f;
+    const auto message = std::string(56, 'x');
+    // 64 bytes per record
+    for (auto i = 0u; i < 4u; ++i)
+    {
+        EXPECT_TRUE(f.write(message));
+    }
+    EXPECT_FALSE(f.write("y"));
+
+    EXPECT_EQ(f.read(1).size(), 1);
+    EXPECT_TRUE(f.write("y"));
+    EXPECT_EQ(f.read().size(), 4);
+}
+
+TEST(shm_ring, keeps_records_contiguous_across_the_end)
+{
+    Fixture f;
+    const auto max = nil::service::shm::Ring::max_payload(CAPACITY);
+    // 3 records of 72 bytes leave 40 bytes before the end
+    for (auto i = 0u; i < 3u; ++i)
+    {
+        EXPECT_TRUE(f.write(std::string(64, char('a' + i))));
+    }
+    EXPECT_EQ(f.read().size(), 3);
+
+    // does not fit before the end, starts over at the beginning
+    const auto large = std::string(max, 'z');
+    EXPECT_TRUE(f.write(large));
+    EXPECT_TRUE(f.write("tail"));
+    EXPECT_EQ(f.read(), (std::vector<std::string>{large, "tail"}));
+    EXPECT_TRUE(f.ring.empty());
+}
+
+TEST(shm_ring, discards_the_unread_messages)
+{
+    Fixture f;
+    EXPECT_TRUE(f.write("a"));
+    EXPECT_TRUE(f.write("b"));
+    f.ring.discard();
+    EXPECT_TRUE(f.ring.empty());
+    EXPECT_TRUE(f.read().empty());
+}
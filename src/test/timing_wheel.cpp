@@ -0,0 +1,71 @@
+#include "../../src/src/TimingWheel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    using Wheel = nil::service::TimingWheel<int>;
+
+    std::vector<int*> advance(Wheel& wheel, Wheel::clock::time_point now)
+    {
+        std::vector<int*> due;
+        wheel.advance(now, [&](int* item) { due.push_back(item); });
+        return due;
+    }
+}
+
+TEST(timing_wheel, hands_back_items_once_due)
+{
+    const auto start = Wheel::clock::now();
+    Wheel wheel(10ms, 100ms);
+    int a = 0;
+    int b = 0;
+    wheel.schedule(&a, start + 30ms);
+    wheel.schedule(&b, start + 80ms);
+    EXPECT_FALSE(wheel.empty());
+
+    EXPECT_TRUE(advance(wheel, start).empty());
+    EXPECT_EQ(advance(wheel, start + 50ms), std::vector<int*>{&a});
+    EXPECT_EQ(advance(wheel, start + 100ms), std::vector<int*>{&b});
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel, reschedules_from_the_sweep)
+{
+    const auto start = Wheel::clock::now();
+    Wheel wheel(10ms, 100ms);
+    int a = 0;
+    wheel.schedule(&a, start + 20ms);
+
+    auto count = 0;
+    wheel.advance(
+        start + 40ms,
+        [&](int* item)
+        {
+            ++count;
+            wheel.schedule(item, start + 90ms);
+        }
+    );
+    EXPECT_EQ(count, 1);
+    EXPECT_TRUE(advance(wheel, start + 60ms).empty());
+    EXPECT_EQ(advance(wheel, start + 110ms), std::vector<int*>{&a});
+}
+
+TEST(timing_wheel, visits_every_slot_after_a_stall)
+{
+    const auto start = Wheel::clock::now();
+    Wheel wheel(10ms, 50ms);
+    std::vector<int> items(5);
+    for (auto i = 0u; i < items.size(); ++i)
+    {
+        wheel.schedule(&items[i], start + (10ms * (i + 1)));
+    }
+
+    EXPECT_EQ(advance(wheel, start + 10s).size(), items.size());
+    EXPECT_TRUE(wheel.empty());
+}
@@ -0,0 +1,132 @@
+#include <nil/service/udp/multicast/create.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    namespace ns = nil::service;
+
+    template <typename Predicate>
+    bool wait_for(Predicate predicate)
+    {
+        const auto until = std::chrono::steady_clock::now() + 5s;
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > until)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    ns::udp::multicast::Options loopback_options(std::uint16_t port)
+    {
+        return {.group = "239.255.0.1", .port = port, .interface_address = "127.0.0.1"};
+    }
+
+    // a member run by its own thread, recording what it receives
+    struct Member final
+    {
+        explicit Member(ns::udp::multicast::Options options)
+            : service(ns::udp::multicast::create(std::move(options)))
+        {
+            service->on_connect([this]() { ++joined; });
+            service->on_disconnect([this]() { ++forgotten; });
+            service->on_message(
+                [this](const ns::ID& id, const void*, std::uint64_t size)
+                {
+                    const std::lock_guard lock(mutex);
+                    last = id;
+                    sizes.push_back(size);
+                }
+            );
+            thread = std::thread([this]() { service->run(); });
+        }
+
+        ~Member()
+        {
+            service->stop();
+            thread.join();
+        }
+
+        Member(Member&&) = delete;
+        Member(const Member&) = delete;
+        Member& operator=(Member&&) = delete;
+        Member& operator=(const Member&) = delete;
+
+        std::size_t received()
+        {
+            const std::lock_guard lock(mutex);
+            return sizes.size();
+        }
+
+        ns::ID sender()
+        {
+            const std::lock_guard lock(mutex);
+            return last;
+        }
+
+        std::unique_ptr<ns::IStandaloneService> service;
+        std::atomic<int> joined = 0;
+        std::atomic<int> forgotten = 0;
+        std::mutex mutex;
+        ns::ID last;
+        std::vector<std::uint64_t> sizes;
+        std::thread thread;
+    };
+}
+
+TEST(udp_multicast, publishes_and_replies_over_loopback)
+{
+    Member a(loopback_options(17311));
+    Member b(loopback_options(17311));
+    ASSERT_TRUE(wait_for([&]() { return a.joined == 1 && b.joined == 1; }));
+
+    a.service->publish(std::vector<std::uint8_t>(16, 1));
+    ASSERT_TRUE(wait_for([&]() { return b.received() == 1; }));
+    EXPECT_EQ(a.received(), 0);
+
+    b.service->send(b.sender(), std::vector<std::uint8_t>(5, 2));
+    ASSERT_TRUE(wait_for([&]() { return a.received() == 1; }));
+    EXPECT_EQ(a.sizes.front(), 5);
+}
+
+TEST(udp_multicast, forgets_silent_members)
+{
+    auto options = loopback_options(17312);
+    options.member_timeout_ms = 50;
+    Member a(options);
+    Member b(options);
+    ASSERT_TRUE(wait_for([&]() { return a.joined == 1 && b.joined == 1; }));
+
+    a.service->publish(std::vector<std::uint8_t>(16, 1));
+    ASSERT_TRUE(wait_for([&]() { return b.received() == 1; }));
+    ASSERT_TRUE(wait_for([&]() { return b.forgotten == 1; }));
+
+    // the id of a forgotten member no longer reaches it
+    b.service->send(b.sender(), std::vector<std::uint8_t>(5, 2));
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(a.received(), 0);
+}
+
+TEST(udp_multicast, throws_when_the_group_can_not_be_joined)
+{
+    auto not_multicast = loopback_options(17313);
+    not_multicast.group = "127.0.0.1";
+    EXPECT_ANY_THROW(ns::udp::multicast::create(not_multicast));
+
+    auto other_family = loopback_options(17313);
+    other_family.interface_address = "::1";
+    EXPECT_ANY_THROW(ns::udp::multicast::create(other_family));
+}
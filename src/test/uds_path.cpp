@@ -0,0 +1,80 @@
+#include <nil/service/uds/server/create.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    bool exists(const std::string& path)
+    {
+        struct stat info = {};
+        return ::lstat(path.c_str(), &info) == 0;
+    }
+
+    // a socket file bound then closed without listening: what a crashed server leaves behind
+    void leave_stale_socket(const std::string& path)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        ASSERT_EQ(::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        ::close(fd);
+    }
+
+    std::string test_path(const char* name)
+    {
+        auto path = "/tmp/nil_service_uds_path_" + std::to_string(::getpid()) + "_" + name;
+        ::unlink(path.c_str());
+        return path;
+    }
+}
+
+TEST(uds_path, replaces_stale_socket)
+{
+    const auto path = test_path("stale");
+    leave_stale_socket(path);
+    {
+        auto server = nil::service::uds::server::create({.path = path});
+        EXPECT_TRUE(exists(path));
+    }
+    EXPECT_FALSE(exists(path));
+}
+
+TEST(uds_path, keeps_regular_file)
+{
+    const auto path = test_path("file");
+    std::ofstream(path) << "data";
+    EXPECT_ANY_THROW(nil::service::uds::server::create({.path = path}));
+    EXPECT_TRUE(exists(path));
+    ::unlink(path.c_str());
+}
+
+TEST(uds_path, keeps_socket_of_listening_server)
+{
+    const auto path = test_path("live");
+    auto first = nil::service::uds::server::create({.path = path});
+    EXPECT_ANY_THROW(nil::service::uds::server::create({.path = path}));
+    EXPECT_TRUE(exists(path));
+    first.reset();
+    EXPECT_FALSE(exists(path));
+}
+
+TEST(uds_path, restart_recreates_socket)
+{
+    const auto path = test_path("restart");
+    auto server = nil::service::uds::server::create({.path = path});
+    server->restart();
+    EXPECT_TRUE(exists(path));
+    server.reset();
+    EXPECT_FALSE(exists(path));
+}
@@ -0,0 +1,45 @@
+#include "../../src/src/ws/Deflate.hpp"
+
+#include <gtest/gtest.h>
+
+#include <boost/beast/http/fields.hpp>
+
+TEST(ws_deflate, option_follows_role)
+{
+    using boost::beast::role_type;
+    using nil::service::ws::deflate_option;
+    const nil::service::ws::Compression compression{
+        .enabled = true,
+        .window_bits = 12,
+        .mem_level = 6,
+        .level = 3,
+        .context_takeover = false
+    };
+
+    const auto server = deflate_option(compression, role_type::server);
+    ASSERT_TRUE(server.server_enable);
+    ASSERT_FALSE(server.client_enable);
+    ASSERT_EQ(server.server_max_window_bits, 12);
+    ASSERT_EQ(server.client_max_window_bits, 12);
+    ASSERT_TRUE(server.server_no_context_takeover);
+    ASSERT_TRUE(server.client_no_context_takeover);
+    ASSERT_EQ(server.compLevel, 3);
+    ASSERT_EQ(server.memLevel, 6);
+
+    const auto client = deflate_option(compression, role_type::client);
+    ASSERT_FALSE(client.server_enable);
+    ASSERT_TRUE(client.client_enable);
+}
+
+TEST(ws_deflate, negotiation)
+{
+    boost::beast::http::fields fields;
+    ASSERT_FALSE(nil::service::ws::negotiates_deflate({.enabled = true}, fields));
+
+    fields.set(
+        boost::beast::http::field::sec_websocket_extensions,
+        "permessage-deflate; client_max_window_bits"
+    );
+    ASSERT_TRUE(nil::service::ws::negotiates_deflate({.enabled = true}, fields));
+    ASSERT_FALSE(nil::service::ws::negotiates_deflate({.enabled = false}, fields));
+}
@@ -0,0 +1,25 @@
+#include "../../src/src/ws/FrameStream.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    std::vector<std::uint8_t> header_of(std::uint64_t size)
+    {
+        const auto header = nil::service::ws::frame_header(size);
+        return {header.data(), header.data() + header.size()};
+    }
+}
+
+TEST(ws_frame, header_lengths)
+{
+    using bytes = std::vector<std::uint8_t>;
+    ASSERT_EQ(header_of(0), (bytes{0x82, 0}));
+    ASSERT_EQ(header_of(125), (bytes{0x82, 125}));
+    ASSERT_EQ(header_of(126), (bytes{0x82, 126, 0, 126}));
+    ASSERT_EQ(header_of(0xFFFF), (bytes{0x82, 126, 0xFF, 0xFF}));
+    ASSERT_EQ(header_of(0x10000), (bytes{0x82, 127, 0, 0, 0, 0, 0, 1, 0, 0}));
+}